@@ -0,0 +1,51 @@
+#!/usr/bin/env bash
+# Runtime of a tight array loop with and without --no-bounds-checks.
+#
+# Usage: benchmarks/array_bounds.sh [repetitions] [optimization level]
+# The compiler binary can be overridden with COMPILER=path/to/Compiler and the
+# C compiler used to link the object files with CC=path/to/cc
+
+set -euo pipefail
+
+REPETITIONS=${1:-20000}
+LEVEL=${2:-2}
+COMPILER=${COMPILER:-./build/Compiler}
+CC=${CC:-cc}
+WORKDIR=$(mktemp -d)
+trap 'rm -rf "$WORKDIR"' EXIT
+
+# The first loop has a provable index range, so its checks should fold away
+# on their own. The second one indexes through a computed position.
+cat > "$WORKDIR/array.shq" <<SHQ
+fn int main() {
+  var int[4096] data;
+  for (var int i = 0; i < 4096; i += 1;) {
+    data[i] = i % 13;
+  }
+
+  var int total = 0;
+  for (var int repetition = 0; repetition < $REPETITIONS; repetition += 1;) {
+    for (var int i = 0; i < 4096; i += 1;) {
+      total += data[(i * 7 + repetition) % 4096];
+    }
+  }
+  return total % 256;
+}
+SHQ
+
+run() {
+  local name=$1
+  shift
+  "$COMPILER" -O"$LEVEL" "$@" -o "$WORKDIR/$name.o" "$WORKDIR/array.shq" > /dev/null
+  "$CC" "$WORKDIR/$name.o" -o "$WORKDIR/$name"
+
+  local start end status=0
+  start=$(date +%s.%N)
+  "$WORKDIR/$name" || status=$?
+  end=$(date +%s.%N)
+  echo "  $name: $(awk "BEGIN { print $end - $start }") seconds (exit code $status)"
+}
+
+echo "$REPETITIONS x 4096 element loop, -O$LEVEL"
+run checked
+run unchecked --no-bounds-checks
@@ -0,0 +1,46 @@
+#!/usr/bin/env bash
+# Compile time of a program with many call sites: every caller calls the callees
+# once per statement, with the callees defined after the callers (forward
+# references) and before them. -O0 by default so code generation dominates.
+#
+# Usage: benchmarks/call_codegen.sh [callers] [calls per caller] [callees] [optimization level]
+# The compiler binary can be overridden with COMPILER=path/to/Compiler
+
+set -euo pipefail
+
+CALLERS=${1:-100}
+CALLS=${2:-1000}
+CALLEES=${3:-100}
+LEVEL=${4:-0}
+COMPILER=${COMPILER:-./build/Compiler}
+WORKDIR=$(mktemp -d)
+trap 'rm -rf "$WORKDIR"' EXIT
+
+callees() {
+  for ((k = 0; k < CALLEES; k++)); do
+    printf 'fn int64 callee_%d(int64 x) {\n  return x * int64(%d) + int64(1);\n}\n\n' "$k" "$((k + 3))"
+  done
+}
+
+callers() {
+  for ((j = 0; j < CALLERS; j++)); do
+    printf 'fn int64 caller_%d(int64 x) {\n' "$j"
+    for ((i = 0; i < CALLS; i++)); do
+      printf '  x = callee_%d(x);\n' "$(((j * 7 + i) % CALLEES))"
+    done
+    printf '  return x;\n}\n\n'
+  done
+}
+
+main() {
+  printf 'fn int main() {\n  return int(caller_0(int64(1)) %% int64(256));\n}\n'
+}
+
+{ callers; callees; main; } > "$WORKDIR/forward.shq"
+{ callees; callers; main; } > "$WORKDIR/backward.shq"
+
+echo "$CALLERS callers x $CALLS calls to $CALLEES callees, -O$LEVEL"
+for order in forward backward; do
+  seconds=$("$COMPILER" -O"$LEVEL" -o "$WORKDIR/$order.o" "$WORKDIR/$order.shq" | grep "Compiling took" | awk '{ print $3 }')
+  echo "  callees defined $order: $seconds seconds"
+done
@@ -0,0 +1,74 @@
+#!/usr/bin/env bash
+# Runtime of a loop calling a function once per element, with the function
+# emitted as #export (external linkage, what every function used to get), with
+# the default internal linkage, with #inline and with #noinline.
+#
+# Usage: benchmarks/function_inlining.sh [statements] [repetitions] [optimization level]
+# The compiler binary can be overridden with COMPILER=path/to/Compiler and the
+# C compiler used to link the object files with CC=path/to/cc
+
+set -euo pipefail
+
+STATEMENTS=${1:-40}
+REPETITIONS=${2:-10000}
+LEVEL=${3:-2}
+COMPILER=${COMPILER:-./build/Compiler}
+CC=${CC:-cc}
+WORKDIR=$(mktemp -d)
+trap 'rm -rf "$WORKDIR"' EXIT
+
+# With enough statements the callee is over the inliner threshold, it's only
+# inlined when the inliner can see it's the last call to an internal function
+build() {
+  local name=$1 annotation=$2
+  {
+    echo "$annotation"
+    echo "fn int64 mix(int64 x, int64 k) {"
+    echo "  var int64 h = x;"
+    for index in $(seq 1 "$STATEMENTS"); do
+      echo "  h = h * int64(31) + k + int64($index);"
+    done
+    echo "  return h;"
+    echo "}"
+    cat <<SHQ
+
+fn int main() {
+  var int64[4096] data;
+  for (var int i = 0; i < 4096; i += 1;) {
+    data[i] = int64(i) * int64(2654435761) % int64(1000003);
+  }
+
+  var int64 total = 0;
+  for (var int repetition = 0; repetition < $REPETITIONS; repetition += 1;) {
+    for (var int i = 0; i < 4096; i += 1;) {
+      total += mix(data[i], int64(repetition));
+    }
+  }
+  return int(total % int64(256));
+}
+SHQ
+  } > "$WORKDIR/$name.shq"
+  "$COMPILER" -O"$LEVEL" -o "$WORKDIR/$name.o" "$WORKDIR/$name.shq" > /dev/null
+  "$CC" "$WORKDIR/$name.o" -o "$WORKDIR/$name"
+}
+
+run() {
+  local name=$1
+
+  local start end status=0
+  start=$(date +%s.%N)
+  "$WORKDIR/$name" || status=$?
+  end=$(date +%s.%N)
+  echo "  $name: $(awk "BEGIN { print $end - $start }") seconds (exit code $status)"
+}
+
+build exported "#export"
+build internal ""
+build always_inline "#inline"
+build never_inline "#noinline"
+
+echo "$REPETITIONS x 4096 calls to a $STATEMENTS statement function, -O$LEVEL"
+run exported
+run internal
+run always_inline
+run never_inline
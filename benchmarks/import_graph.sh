@@ -0,0 +1,59 @@
+#!/usr/bin/env bash
+# Benchmark for import: generates a chain of libraries where every one imports the one before it,
+# and compares compiling the program that imports the last one with and without their interfaces.
+# The first compilation parses every library and writes its .shqi file, the next ones only read them.
+#
+# Usage: benchmarks/import_graph.sh [libraries] [functions per library] [optimization level]
+# The compiler binary can be overridden with COMPILER=path/to/Compiler
+
+set -euo pipefail
+
+LIBRARIES=${1:-32}
+FUNCTIONS=${2:-200}
+LEVEL=${3:-2}
+COMPILER=${COMPILER:-./build/Compiler}
+WORKDIR=$(mktemp -d)
+trap 'rm -rf "$WORKDIR"' EXIT
+
+# Every library has structs, constants and private functions, and exports one function using them
+for ((library = 0; library < LIBRARIES; library++)); do
+  SOURCE="$WORKDIR/library_$library.shq"
+  if ((library > 0)); then
+    printf 'import "library_%d.shq";\n\n' $((library - 1)) > "$SOURCE"
+  fi
+  printf 'const int32 BASE_%d = %d * 4 + 1;\n' "$library" "$library" >> "$SOURCE"
+  printf 'const float64[4] WEIGHTS_%d = {0.5, 1.5, 2.5, 3.5};\n' "$library" >> "$SOURCE"
+  printf 'struct Record_%d {\n  var int32 id = BASE_%d;\n  var int64 total;\n  var float64 weight = 0.25;\n};\n' "$library" "$library" >> "$SOURCE"
+  for ((i = 0; i < FUNCTIONS; i++)); do
+    cat >> "$SOURCE" <<SHQ
+fn int32 helper_${library}_$i(int32 a, int32 b) {
+  var int32 x = a * 3 + b;
+  var int32 y = x - $i;
+  if (x > y) {
+    y = y + BASE_$library;
+  }
+  return x * y % 7;
+}
+SHQ
+  done
+  printf '#export\nfn int32 entry_%d(int32 a) {\n  var Record_%d record;\n  return helper_%d_0(a, record.id);\n}\n' "$library" "$library" "$library" >> "$SOURCE"
+done
+
+printf 'import "library_%d.shq";\n\nfn int32 main() {\n  var Record_%d record;\n  return entry_%d(BASE_%d) + record.id;\n}\n' \
+  $((LIBRARIES - 1)) $((LIBRARIES - 1)) $((LIBRARIES - 1)) $((LIBRARIES - 1)) > "$WORKDIR/main.shq"
+
+compile() {
+  "$COMPILER" -O"$LEVEL" -o "$WORKDIR/main.o" "$WORKDIR/main.shq" | grep "Compiling took" | awk '{ print $3 }'
+}
+
+echo "$LIBRARIES libraries of $FUNCTIONS functions imported in a chain, -O$LEVEL"
+echo "  without interfaces: $(compile) seconds"
+echo "  with interfaces:    $(compile) seconds"
+touch "$WORKDIR/library_0.shq"
+echo "  first library touched, interfaces still valid: $(compile) seconds"
+printf '\n' >> "$WORKDIR/library_0.shq"
+echo "  first library edited, every interface rebuilt: $(compile) seconds"
+
+SOURCE_BYTES=$(cat "$WORKDIR"/library_*.shq | wc -c)
+INTERFACE_BYTES=$(cat "$WORKDIR"/library_*.shqi | wc -c)
+echo "  sources: $SOURCE_BYTES bytes, interfaces: $INTERFACE_BYTES bytes"
@@ -0,0 +1,68 @@
+#!/usr/bin/env bash
+# Runtime of a hot loop calling small functions defined in another file, with the files
+# compiled to separate objects, and linked with full LTO and with ThinLTO.
+#
+# Usage: benchmarks/lto_inlining.sh [iterations] [optimization level]
+# The compiler binary can be overridden with COMPILER=path/to/Compiler and the
+# C compiler used to link the object files with CC=path/to/cc
+
+set -euo pipefail
+
+ITERATIONS=${1:-200000000}
+LEVEL=${2:-2}
+COMPILER=${COMPILER:-./build/Compiler}
+CC=${CC:-cc}
+WORKDIR=$(mktemp -d)
+trap 'rm -rf "$WORKDIR"' EXIT
+
+cat > "$WORKDIR/helpers.shq" <<SHQ
+#export fn int64 mix(int64 value, int64 i) {
+  return value * 31 + i % 7;
+}
+
+#export fn int64 clamp(int64 value) {
+  if (value > 1000000) {
+    return value - 1000000;
+  }
+  return value;
+}
+SHQ
+
+# The loop only sees the declarations, without LTO every iteration makes two calls
+cat > "$WORKDIR/main.shq" <<SHQ
+fn int64 mix(int64 value, int64 i);
+fn int64 clamp(int64 value);
+
+fn int main() {
+  var int64 value = 0;
+  for (var int64 i = 0; i < $ITERATIONS; i += 1;) {
+    value = clamp(mix(value, i) % 1000003);
+  }
+  return int(value % 256);
+}
+SHQ
+
+run() {
+  local name=$1
+  "$CC" "$WORKDIR/$name.o" -o "$WORKDIR/$name"
+
+  local start end status=0
+  start=$(date +%s.%N)
+  "$WORKDIR/$name" || status=$?
+  end=$(date +%s.%N)
+  echo "  $name: $(awk "BEGIN { print $end - $start }") seconds (exit code $status)"
+}
+
+echo "$ITERATIONS iterations calling two functions of another file, -O$LEVEL"
+
+"$COMPILER" -O"$LEVEL" -o "$WORKDIR/helpers.o" "$WORKDIR/helpers.shq" > /dev/null
+"$COMPILER" -O"$LEVEL" -o "$WORKDIR/main.o" "$WORKDIR/main.shq" > /dev/null
+"$CC" -r "$WORKDIR/main.o" "$WORKDIR/helpers.o" -o "$WORKDIR/separate.o"
+run separate
+
+for mode in full thin; do
+  "$COMPILER" -O"$LEVEL" --lto=$mode -o "$WORKDIR/helpers.bc" "$WORKDIR/helpers.shq" > /dev/null
+  "$COMPILER" -O"$LEVEL" --lto=$mode -o "$WORKDIR/main.bc" "$WORKDIR/main.shq" > /dev/null
+  "$COMPILER" -O"$LEVEL" --lto=$mode -o "$WORKDIR/$mode.o" "$WORKDIR/main.bc" "$WORKDIR/helpers.bc" > /dev/null
+  run $mode
+done
@@ -0,0 +1,31 @@
+#!/usr/bin/env bash
+# Scaling benchmark for --ir-threads: generates a program with many functions
+# and compares the compile time while increasing the number of IR threads.
+#
+# Usage: benchmarks/parallel_codegen.sh [functions] [optimization level]
+# The compiler binary can be overridden with COMPILER=path/to/Compiler
+
+set -euo pipefail
+
+FUNCTIONS=${1:-5000}
+LEVEL=${2:-2}
+COMPILER=${COMPILER:-./build/Compiler}
+SOURCE=$(mktemp --suffix=.shq)
+trap 'rm -f "$SOURCE"' EXIT
+
+for ((i = 0; i < FUNCTIONS; i++)); do
+  cat >> "$SOURCE" <<SHQ
+fn int function_$i(int a, int b) {
+  var int x = a * 3 + b;
+  var int y = x - $i;
+  return $i * 3 + 4 / 5 % 7;
+}
+SHQ
+done
+printf 'fn int main() {\n  return 0;\n}\n' >> "$SOURCE"
+
+echo "$FUNCTIONS functions, -O$LEVEL"
+for threads in 1 2 4 8; do
+  seconds=$("$COMPILER" -O"$LEVEL" --ir-threads="$threads" "$SOURCE" | grep "Compiling took" | awk '{ print $3 }')
+  echo "  --ir-threads=$threads: $seconds seconds"
+done
@@ -0,0 +1,38 @@
+#!/usr/bin/env bash
+# Speedup of -j/--codegen-threads on the object emission of a generated
+# program of about 100k lines.
+#
+# Usage: benchmarks/parallel_emission.sh [lines] [optimization level]
+# The compiler binary can be overridden with COMPILER=path/to/Compiler
+
+set -euo pipefail
+
+LINES=${1:-100000}
+LEVEL=${2:-2}
+COMPILER=${COMPILER:-./build/Compiler}
+SOURCE=$(mktemp --suffix=.shq)
+OUTPUT=$(mktemp --suffix=.o)
+trap 'rm -f "$SOURCE" "$OUTPUT"' EXIT
+
+# Every function is 10 lines long
+for ((i = 0; i < LINES / 10; i++)); do
+  cat >> "$SOURCE" <<SHQ
+fn int function_$i(int a, int b) {
+  var int x = a * 3 + b;
+  var int y = x - $i;
+  var int z = y * x;
+  x = x + y * z;
+  y = y - x / 7;
+  z = z * y % 5;
+  return $i * 3 + 4 / 5 % 7;
+}
+
+SHQ
+done
+printf 'fn int main() {\n  return 0;\n}\n' >> "$SOURCE"
+
+echo "$(wc -l < "$SOURCE") lines, -O$LEVEL"
+for threads in 1 2 4 8; do
+  seconds=$("$COMPILER" -O"$LEVEL" -o "$OUTPUT" -j "$threads" "$SOURCE" | grep "Emitting object took" | awk '{ print $4 }')
+  echo "  -j $threads: $seconds seconds"
+done
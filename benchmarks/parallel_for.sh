@@ -0,0 +1,68 @@
+#!/usr/bin/env bash
+# Scaling benchmark for `parallel for`: a CPU-bound loop run with an increasing
+# number of runtime workers (SHQ_THREADS), then with a few #chunk sizes.
+#
+# Usage: benchmarks/parallel_for.sh [iterations] [work per iteration] [optimization level]
+# The compiler binary can be overridden with COMPILER=path/to/Compiler and the
+# C compiler used to link the object files with CC=path/to/cc
+
+set -euo pipefail
+
+ITERATIONS=${1:-100000}
+WORK=${2:-50000}
+LEVEL=${3:-2}
+COMPILER=${COMPILER:-./build/Compiler}
+CC=${CC:-cc}
+WORKDIR=$(mktemp -d)
+trap 'rm -rf "$WORKDIR"' EXIT
+
+# Every iteration runs a chain of multiplications the optimizer can't shorten
+build() {
+  local name=$1 annotation=$2
+  cat > "$WORKDIR/$name.shq" <<SHQ
+fn int main() {
+  var uint32[$ITERATIONS] results;
+  $annotation
+  parallel for (var int i = 0; i < $ITERATIONS; i += 1;) {
+    var uint32 x = i;
+    for (var int k = 0; k < $WORK; k += 1;) {
+      x = x * 1664525 + 1013904223;
+    }
+    results[i] = x;
+  }
+
+  var uint32 total = 0;
+  for (var int i = 0; i < $ITERATIONS; i += 1;) {
+    total += results[i];
+  }
+  return total % 256;
+}
+SHQ
+  "$COMPILER" -O"$LEVEL" -o "$WORKDIR/$name.o" "$WORKDIR/$name.shq" > /dev/null
+  "$CC" "$WORKDIR/$name.o" -o "$WORKDIR/$name" -pthread
+}
+
+run() {
+  local label=$1 name=$2 threads=$3
+
+  local start end status=0
+  start=$(date +%s.%N)
+  SHQ_THREADS=$threads "$WORKDIR/$name" || status=$?
+  end=$(date +%s.%N)
+  echo "  $label: $(awk "BEGIN { print $end - $start }") seconds (checksum $status)"
+}
+
+build automatic ""
+build chunk1 "#chunk(1)"
+build chunk64 "#chunk(64)"
+build chunk4096 "#chunk(4096)"
+
+echo "$ITERATIONS iterations x $WORK multiplications, -O$LEVEL, $(nproc) CPUs"
+for threads in 1 2 4 8; do
+  run "SHQ_THREADS=$threads" automatic "$threads"
+done
+
+THREADS=$(nproc)
+for chunk in 1 64 4096; do
+  run "SHQ_THREADS=$THREADS #chunk($chunk)" "chunk$chunk" "$THREADS"
+done
@@ -0,0 +1,41 @@
+#!/usr/bin/env bash
+# Scaling benchmark for -j: generates a program split in many files and compares
+# the compile time while increasing the number of files compiled at the same time.
+#
+# Usage: benchmarks/parallel_frontends.sh [files] [functions per file] [optimization level]
+# The compiler binary can be overridden with COMPILER=path/to/Compiler
+
+set -euo pipefail
+
+FILES=${1:-16}
+FUNCTIONS=${2:-500}
+LEVEL=${3:-2}
+COMPILER=${COMPILER:-./build/Compiler}
+WORKDIR=$(mktemp -d)
+trap 'rm -rf "$WORKDIR"' EXIT
+
+# Every file exports a function main calls through a declaration
+SOURCES=()
+for ((file = 0; file < FILES; file++)); do
+  SOURCE="$WORKDIR/file_$file.shq"
+  SOURCES+=("$SOURCE")
+  for ((i = 0; i < FUNCTIONS; i++)); do
+    cat >> "$SOURCE" <<SHQ
+fn int function_$i(int a, int b) {
+  var int x = a * 3 + b;
+  var int y = x - $i;
+  return $i * 3 + 4 / 5 % 7;
+}
+SHQ
+  done
+  printf '#export\nfn int entry_%d(int a) {\n  return function_0(a, %d);\n}\n' "$file" "$file" >> "$SOURCE"
+  printf 'fn int entry_%d(int a);\n' "$file" >> "$WORKDIR/main.shq"
+done
+printf 'fn int main() {\n  return entry_0(1);\n}\n' >> "$WORKDIR/main.shq"
+SOURCES+=("$WORKDIR/main.shq")
+
+echo "$FILES files of $FUNCTIONS functions, -O$LEVEL"
+for jobs in 1 2 4 8; do
+  seconds=$("$COMPILER" -O"$LEVEL" -j "$jobs" -o "$WORKDIR/program.o" "${SOURCES[@]}" | grep "Compiling took" | awk '{ print $3 }')
+  echo "  -j $jobs: $seconds seconds"
+done
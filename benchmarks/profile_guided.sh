@@ -0,0 +1,57 @@
+#!/usr/bin/env bash
+# Runtime of a program optimized with and without the profile of a previous run.
+# The training run uses the JIT, which writes an indexed profile directly.
+#
+# Usage: benchmarks/profile_guided.sh [iterations] [optimization level]
+# The compiler binary can be overridden with COMPILER=path/to/Compiler and the
+# C compiler used to link the object files with CC=path/to/cc
+
+set -euo pipefail
+
+ITERATIONS=${1:-50000000}
+LEVEL=${2:-2}
+COMPILER=${COMPILER:-./build/Compiler}
+CC=${CC:-cc}
+WORKDIR=$(mktemp -d)
+trap 'rm -rf "$WORKDIR"' EXIT
+
+# The rare path is as large as the common one, without the counts the optimizer
+# can't tell which one to keep inline and fall through to
+cat > "$WORKDIR/skewed.shq" <<SHQ
+fn int64 step(int64 value, int64 i) {
+  if (i % 1024 == 0) {
+    return (value * 31 + i) % 1000003;
+  }
+  else if (i % 3 == 0) {
+    return value + (i % 7);
+  }
+  return value + 1;
+}
+
+fn int main() {
+  var int64 value = 0;
+  for (var int64 i = 0; i < $ITERATIONS; i += 1;) {
+    value = step(value, i);
+  }
+  return int(value % 256);
+}
+SHQ
+
+run() {
+  local name=$1
+  shift
+  "$COMPILER" -O"$LEVEL" "$@" -o "$WORKDIR/$name.o" "$WORKDIR/skewed.shq" > /dev/null
+  "$CC" "$WORKDIR/$name.o" -o "$WORKDIR/$name"
+
+  local start end status=0
+  start=$(date +%s.%N)
+  "$WORKDIR/$name" || status=$?
+  end=$(date +%s.%N)
+  echo "  $name: $(awk "BEGIN { print $end - $start }") seconds (exit code $status)"
+}
+
+"$COMPILER" -O"$LEVEL" --profile-generate="$WORKDIR/skewed.profdata" "$WORKDIR/skewed.shq" > /dev/null
+
+echo "$ITERATIONS iterations with a skewed branch, -O$LEVEL"
+run plain
+run guided --profile-use="$WORKDIR/skewed.profdata"
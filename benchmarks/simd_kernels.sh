@@ -0,0 +1,123 @@
+#!/usr/bin/env bash
+# Runtime of a dot product and a saxpy kernel written with scalar arrays and
+# with float32x8 vectors. The scalar dot product is a serial floating point
+# chain the optimizer can't reorder, the vector one keeps 8 partial sums.
+#
+# Usage: benchmarks/simd_kernels.sh [repetitions] [optimization level]
+# The compiler binary can be overridden with COMPILER=path/to/Compiler and the
+# C compiler used to link the object files with CC=path/to/cc
+
+set -euo pipefail
+
+REPETITIONS=${1:-20000}
+LEVEL=${2:-2}
+COMPILER=${COMPILER:-./build/Compiler}
+CC=${CC:-cc}
+WORKDIR=$(mktemp -d)
+trap 'rm -rf "$WORKDIR"' EXIT
+
+# Every kernel works on 4096 floats, both versions of a kernel return the same checksum
+cat > "$WORKDIR/dot_scalar.shq" <<SHQ
+fn int main() {
+  var float32[4096] x;
+  var float32[4096] y;
+  for (var int i = 0; i < 4096; i += 1;) {
+    x[i] = float32(i % 7);
+    y[i] = float32(i % 5);
+  }
+
+  var int total = 0;
+  for (var int repetition = 0; repetition < $REPETITIONS; repetition += 1;) {
+    var float32 dot = 0.0;
+    for (var int i = 0; i < 4096; i += 1;) {
+      dot += x[i] * y[i];
+    }
+    total += int(dot);
+
+    for (var int lane = 0; lane < 8; lane += 1;) {
+      x[(repetition % 512) * 8 + lane] += 1.0;
+    }
+  }
+  return total % 256;
+}
+SHQ
+
+cat > "$WORKDIR/dot_vector.shq" <<SHQ
+fn int main() {
+  var float32x8[512] x;
+  var float32x8[512] y;
+  var int32x8 lanes = {0, 1, 2, 3, 4, 5, 6, 7};
+  for (var int i = 0; i < 512; i += 1;) {
+    x[i] = float32x8((int32x8(i * 8) + lanes) % 7);
+    y[i] = float32x8((int32x8(i * 8) + lanes) % 5);
+  }
+
+  var int total = 0;
+  for (var int repetition = 0; repetition < $REPETITIONS; repetition += 1;) {
+    var float32x8 dot = 0.0;
+    for (var int i = 0; i < 512; i += 1;) {
+      dot += x[i] * y[i];
+    }
+    total += int(reduce_add(dot));
+
+    x[repetition % 512] += 1.0;
+  }
+  return total % 256;
+}
+SHQ
+
+cat > "$WORKDIR/saxpy_scalar.shq" <<SHQ
+fn int main() {
+  var float32[4096] x;
+  var float32[4096] y;
+  for (var int i = 0; i < 4096; i += 1;) {
+    x[i] = float32(i % 7);
+    y[i] = float32(i % 5);
+  }
+
+  for (var int repetition = 0; repetition < $REPETITIONS; repetition += 1;) {
+    for (var int i = 0; i < 4096; i += 1;) {
+      y[i] = 0.5 * x[i] + y[i];
+    }
+  }
+  return (int(y[4093]) + int(y[4094])) % 256;
+}
+SHQ
+
+cat > "$WORKDIR/saxpy_vector.shq" <<SHQ
+fn int main() {
+  var float32x8[512] x;
+  var float32x8[512] y;
+  var int32x8 lanes = {0, 1, 2, 3, 4, 5, 6, 7};
+  for (var int i = 0; i < 512; i += 1;) {
+    x[i] = float32x8((int32x8(i * 8) + lanes) % 7);
+    y[i] = float32x8((int32x8(i * 8) + lanes) % 5);
+  }
+
+  for (var int repetition = 0; repetition < $REPETITIONS; repetition += 1;) {
+    for (var int i = 0; i < 512; i += 1;) {
+      y[i] = 0.5 * x[i] + y[i];
+    }
+  }
+  return (int(extract(y[511], 5)) + int(extract(y[511], 6))) % 256;
+}
+SHQ
+
+run() {
+  local name=$1
+
+  "$COMPILER" -O"$LEVEL" -o "$WORKDIR/$name.o" "$WORKDIR/$name.shq" > /dev/null
+  "$CC" "$WORKDIR/$name.o" -o "$WORKDIR/$name"
+
+  local start end status=0
+  start=$(date +%s.%N)
+  "$WORKDIR/$name" || status=$?
+  end=$(date +%s.%N)
+  echo "  $name: $(awk "BEGIN { print $end - $start }") seconds (checksum $status)"
+}
+
+echo "$REPETITIONS repetitions over 4096 floats, -O$LEVEL"
+run dot_scalar
+run dot_vector
+run saxpy_scalar
+run saxpy_vector
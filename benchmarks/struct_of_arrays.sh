@@ -0,0 +1,75 @@
+#!/usr/bin/env bash
+# Runtime of a loop updating a single member of an array of structs, with the
+# default array-of-structs layout and with #soa.
+#
+# Usage: benchmarks/struct_of_arrays.sh [elements] [repetitions] [optimization level]
+# The compiler binary can be overridden with COMPILER=path/to/Compiler and the
+# C compiler used to link the object files with CC=path/to/cc
+
+set -euo pipefail
+
+ELEMENTS=${1:-65536}
+REPETITIONS=${2:-1000}
+LEVEL=${3:-2}
+COMPILER=${COMPILER:-./build/Compiler}
+CC=${CC:-cc}
+WORKDIR=$(mktemp -d)
+trap 'rm -rf "$WORKDIR"' EXIT
+
+# Only one member out of eight is used in the hot loop, with the default layout
+# every cache line brings in seven members that aren't touched
+build() {
+  local name=$1 annotation=$2
+  cat > "$WORKDIR/$name.shq" <<SHQ
+struct Order {
+  var int64 price;
+  var int64 quantity;
+  var int64 id;
+  var int64 owner;
+  var int64 timestamp;
+  var int64 flags;
+  var int64 venue;
+  var int64 sequence;
+};
+
+fn int main() {
+  $annotation
+  var Order[$ELEMENTS] orders;
+  for (var int i = 0; i < $ELEMENTS; i += 1;) {
+    orders[i].price = i % 97;
+    orders[i].quantity = i;
+  }
+
+  for (var int repetition = 0; repetition < $REPETITIONS; repetition += 1;) {
+    for (var int i = 0; i < $ELEMENTS; i += 1;) {
+      orders[i].price += repetition;
+    }
+  }
+
+  var int64 total = 0;
+  for (var int i = 0; i < $ELEMENTS; i += 1;) {
+    total += orders[i].price + orders[i].quantity;
+  }
+  return total % 256;
+}
+SHQ
+  "$COMPILER" -O"$LEVEL" -o "$WORKDIR/$name.o" "$WORKDIR/$name.shq" > /dev/null
+  "$CC" "$WORKDIR/$name.o" -o "$WORKDIR/$name"
+}
+
+run() {
+  local name=$1
+
+  local start end status=0
+  start=$(date +%s.%N)
+  "$WORKDIR/$name" || status=$?
+  end=$(date +%s.%N)
+  echo "  $name: $(awk "BEGIN { print $end - $start }") seconds (exit code $status)"
+}
+
+build array_of_structs ""
+build struct_of_arrays "#soa"
+
+echo "$REPETITIONS x $ELEMENTS element loop updating one member of eight, -O$LEVEL"
+run array_of_structs
+run struct_of_arrays
@@ -0,0 +1,76 @@
+#!/usr/bin/env bash
+# Runtime of a bytecode dispatch loop written with a switch and with the
+# equivalent if/else if chain.
+#
+# Usage: benchmarks/switch_dispatch.sh [repetitions] [optimization level]
+# The compiler binary can be overridden with COMPILER=path/to/Compiler and the
+# C compiler used to link the object files with CC=path/to/cc
+
+set -euo pipefail
+
+REPETITIONS=${1:-200000}
+LEVEL=${2:-2}
+COMPILER=${COMPILER:-./build/Compiler}
+CC=${CC:-cc}
+WORKDIR=$(mktemp -d)
+trap 'rm -rf "$WORKDIR"' EXIT
+
+# Both programs run the same bytecode over an accumulator, the opcodes are
+# dense so the switch can become a jump table. The program is exported so the
+# optimizer can't assume its contents and fold the loop away
+PROGRAM="{0, 3, 1, 7, 2, 5, 4, 6, 3, 0, 7, 1, 5, 2, 6, 4, 1, 3, 0, 2, 7, 5, 6, 4, 2, 1, 0, 3, 4, 7, 6, 5}"
+
+write() {
+  local name=$1 dispatch=$2
+  cat > "$WORKDIR/$name.shq" <<SHQ
+#export
+var uint8[32] program = $PROGRAM;
+
+fn int main() {
+  var int64 accumulator = 1;
+  for (var int repetition = 0; repetition < $REPETITIONS; repetition += 1;) {
+    for (var int pc = 0; pc < 32; pc += 1;) {
+      var uint8 op = program[pc];
+$dispatch
+    }
+  }
+  return int(accumulator % 256);
+}
+SHQ
+}
+
+write switch "      switch (op) {
+        case 0 { accumulator += 3; }
+        case 1 { accumulator -= 1; }
+        case 2 { accumulator *= 3; }
+        case 3 { accumulator = accumulator % 1000003; }
+        case 4 { accumulator += int64(pc); }
+        case 5 { accumulator -= 7; }
+        case 6 { accumulator *= 5; }
+        default { accumulator = accumulator % 999983; }
+      }"
+
+write chain "      if (op == 0) { accumulator += 3; }
+      else if (op == 1) { accumulator -= 1; }
+      else if (op == 2) { accumulator *= 3; }
+      else if (op == 3) { accumulator = accumulator % 1000003; }
+      else if (op == 4) { accumulator += int64(pc); }
+      else if (op == 5) { accumulator -= 7; }
+      else if (op == 6) { accumulator *= 5; }
+      else { accumulator = accumulator % 999983; }"
+
+run() {
+  local name=$1
+  "$COMPILER" -O"$LEVEL" -o "$WORKDIR/$name.o" "$WORKDIR/$name.shq" > /dev/null
+  "$CC" "$WORKDIR/$name.o" -o "$WORKDIR/$name"
+
+  local start end status=0
+  start=$(date +%s.%N)
+  "$WORKDIR/$name" || status=$?
+  end=$(date +%s.%N)
+  echo "  $name: $(awk "BEGIN { print $end - $start }") seconds (exit code $status)"
+}
+
+echo "$REPETITIONS x 32 opcode dispatch loop, -O$LEVEL"
+run switch
+run chain
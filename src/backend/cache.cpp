@@ -0,0 +1,132 @@
+#include "cache.h"
+#include "emitter.h"
+
+#include <vector>
+#include <algorithm>
+#include <system_error>
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/raw_ostream.h"
+
+// Bump this every time the codegen output changes for the same source and flags
+static constexpr const char* CACHE_VERSION = "1";
+
+CompilationCache::CompilationCache(const string& directory, const uintmax_t maxSize):
+  m_directory(directory), m_maxSize(maxSize) {
+    std::error_code ec;
+    fs::create_directories(m_directory, ec);
+    if (ec)
+      warning("Couldn't create the cache directory " + directory + ": " + ec.message());
+  }
+
+string CompilationCache::getKey(const string_view source, const string& flags) const {
+  string contents;
+  contents.reserve(source.size() + flags.size() + 32);
+  contents.append(CACHE_VERSION).push_back('\0');
+  contents.append(LLVM_VERSION_STRING).push_back('\0');
+  contents.append(ObjectEmitter::getHostCPU()).push_back('\0');
+  contents.append(ObjectEmitter::getHostFeatures()).push_back('\0');
+  contents.append(flags).push_back('\0');
+  contents.append(source);
+
+  return llvm::toHex(llvm::SHA1::hash(llvm::arrayRefFromStringRef(contents)), true);
+}
+
+unique_ptr<llvm::Module> CompilationCache::load(const string& key, llvm::LLVMContext& context) const {
+  const fs::path path = getEntryPath(key);
+
+  std::error_code ec;
+  if (!fs::exists(path, ec))
+    return nullptr;
+
+  llvm::ErrorOr<unique_ptr<llvm::MemoryBuffer>> buffer = llvm::MemoryBuffer::getFile(path.string());
+  if (!buffer) {
+    warning("Couldn't read cache entry " + path.string() + ": " + buffer.getError().message());
+    return nullptr;
+  }
+
+  llvm::Expected<unique_ptr<llvm::Module>> module = llvm::parseBitcodeFile((*buffer)->getMemBufferRef(), context);
+  if (!module) {
+    warning("Discarding corrupted cache entry " + path.string() + ": " + llvm::toString(module.takeError()));
+    fs::remove(path, ec);
+    return nullptr;
+  }
+
+  // Touching the entry is what keeps it at the back of the eviction queue
+  fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+  return std::move(*module);
+}
+
+void CompilationCache::store(const string& key, const llvm::Module* module) const {
+  const fs::path path = getEntryPath(key);
+
+  // Every compiler writes its own temporary file, they can store the same entry at the same time
+  int descriptor;
+  llvm::SmallString<128> temporaryName;
+  if (std::error_code ec = llvm::sys::fs::createUniqueFile(path.string() + ".tmp%%%%%%%%", descriptor, temporaryName)) {
+    warning("Couldn't write cache entry " + path.string() + ": " + ec.message());
+    return;
+  }
+  const fs::path temporary = temporaryName.str().str();
+
+  {
+    llvm::raw_fd_ostream output(descriptor, true);
+    llvm::WriteBitcodeToFile(*module, output);
+  }
+
+  // Renaming makes the entry visible atomically to other compilers sharing the directory
+  std::error_code ec;
+  fs::rename(temporary, path, ec);
+  if (ec) {
+    warning("Couldn't write cache entry " + path.string() + ": " + ec.message());
+    fs::remove(temporary, ec);
+    return;
+  }
+
+  evict();
+}
+
+fs::path CompilationCache::getEntryPath(const string& key) const {
+  return m_directory / (key + ".bc");
+}
+
+void CompilationCache::evict() const {
+  struct Entry {
+    fs::path path;
+    uintmax_t size;
+    fs::file_time_type lastUse;
+  };
+
+  std::error_code ec;
+  std::vector<Entry> entries;
+  uintmax_t totalSize = 0;
+
+  for (const fs::directory_entry& file : fs::directory_iterator(m_directory, ec)) {
+    if (!file.is_regular_file(ec) || file.path().extension() != ".bc")
+      continue;
+
+    const uintmax_t size = file.file_size(ec);
+    entries.push_back({ file.path(), size, file.last_write_time(ec) });
+    totalSize += size;
+  }
+
+  if (totalSize <= m_maxSize)
+    return;
+
+  std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.lastUse < b.lastUse; });
+
+  for (const Entry& entry : entries) {
+    if (totalSize <= m_maxSize)
+      break;
+
+    if (fs::remove(entry.path, ec))
+      totalSize -= entry.size;
+  }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+// C++ Headers
+#include <string>
+#include <string_view>
+#include <memory>
+#include <filesystem>
+
+// LLVM Headers
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+
+// Compiler Headers
+#include "../includes/error.hpp"
+
+// Using declarations
+using std::string, std::string_view, std::unique_ptr;
+namespace fs = std::filesystem;
+
+// Stores the bitcode produced for a preprocessed source, so an unchanged input
+// skips tokenizer, parser and codegen entirely. Entries are evicted least
+// recently used first once the directory grows past maxSize bytes.
+class CompilationCache {
+public:
+
+  // Constructor
+  CompilationCache(const string& directory, const uintmax_t maxSize);
+
+  string getKey(const string_view source, const string& flags) const;
+
+  // Returns nullptr on a miss
+  unique_ptr<llvm::Module> load(const string& key, llvm::LLVMContext& context) const;
+  void store(const string& key, const llvm::Module* module) const;
+
+private:
+  const fs::path m_directory;
+  const uintmax_t m_maxSize;
+
+  fs::path getEntryPath(const string& key) const;
+  void evict() const;
+};
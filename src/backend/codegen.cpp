@@ -1,24 +1,246 @@
 #include "codegen.h"
 
-Codegen::Codegen(const vector<unique_ptr<ASTNode>>& ast):
-  ast(std::move(ast)), module(std::make_unique<llvm::Module>("module", context)), builder(context), scope() { generateIR(); }
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/IR/MDBuilder.h"
+#include "llvm/Linker/Linker.h"
+#include "llvm/Support/DynamicLibrary.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/PGOOptions.h"
+#include "llvm/Support/VirtualFileSystem.h"
+#include "llvm/Passes/PassBuilder.h"
+#include "llvm/Transforms/Scalar/SROA.h"
+#include "llvm/Transforms/Utils/Mem2Reg.h"
+
+#include "../runtime/parallel.h"
+#include "passes.h"
+#include "profile.h"
+
+// Every local lives in an entry block alloca, promoting them to SSA values is
+// what keeps even an unoptimized build from going through the stack on every access
+static llvm::FunctionPassManager buildPromotionPipeline() {
+  llvm::FunctionPassManager passes;
+  passes.addPass(llvm::PromotePass());
+#if LLVM_VERSION_MAJOR >= 16
+  passes.addPass(llvm::SROAPass(llvm::SROAOptions::ModifyCFG));
+#else
+  passes.addPass(llvm::SROAPass());
+#endif
+  return passes;
+}
+
+Codegen::Codegen(const vector<unique_ptr<ASTNode>>& ast, const Options& options):
+  options(options), module(std::make_unique<llvm::Module>("module", context)), builder(context), scope(), isWorker(false) { 
+    setTarget();
+    for(const unique_ptr<ASTNode>& node: ast)
+      this->ast.push_back(node.get());
+    generateIR(); 
+  }
+
+Codegen::Codegen(const vector<const ASTNode*>& nodes, const vector<const Function*>& prototypes, const vector<const Variable*>& globals, const Options& options):
+  ast(nodes), options(options), module(std::make_unique<llvm::Module>("module", context)), builder(context), scope(), isWorker(true) {
+    setTarget();
+    for(const Function* prototype: prototypes)
+      declareFunction(prototype);
+
+    // The globals are defined by the module the partitions are linked into, the structs
+    // they're made of come first
+    generateTopLevel(false);
+    for(const Variable* global: globals)
+      generateGlobalVariable(global, false);
+    generateTopLevel(true);
+
+    optimizeFunctions();
+  }
+
+void Codegen::setTarget(){
+  targetMachine = ObjectEmitter::createTargetMachine(options.getOptimizationLevel());
+  module->setTargetTriple(targetMachine->getTargetTriple().str());
+  module->setDataLayout(targetMachine->createDataLayout());
+}
 
 void Codegen::generateIR(){
-  for(const unique_ptr<ASTNode>& node: ast)
-    node->accept(this);
+  if (options.getIRThreads() > 1)
+    generateParallelIR();
+  else {
+    // Every function is declared up front, a call can come before the definition of its callee
+    for(const ASTNode* node: ast)
+      if (node->getNodeType() == ASTNodeType::FUNCTION)
+        declareFunction(dynamic_cast<const Function*>(node));
+
+    generateTopLevel(false);
+    generateTopLevel(true);
+  }
+  internalizeSymbols();
+
+  std::lock_guard<std::mutex> lock(getOutputMutex());
   module->print(llvm::outs(), nullptr);
-  executeIR();
+  llvm::outs().flush();
+}
+
+// Structs and globals come before the functions, the bodies of the functions can use
+// the ones declared after them
+void Codegen::generateTopLevel(const bool isFunction){
+  for(const ASTNode* node: ast)
+    if ((node->getNodeType() == ASTNodeType::FUNCTION) == isFunction)
+      node->accept(this);
+}
+
+void Codegen::generateParallelIR(){
+  vector<const Function*> prototypes;
+  vector<const Variable*> globals;
+  for(const ASTNode* node: ast)
+    if (node->getNodeType() == ASTNodeType::FUNCTION)
+      prototypes.push_back(dynamic_cast<const Function*>(node));
+    else if (node->getNodeType() == ASTNodeType::VARIABLE)
+      globals.push_back(dynamic_cast<const Variable*>(node));
+
+  // Functions are dealt round robin, structs are needed by every partition (and are only
+  // reported once, here) and the globals are defined here and declared by every partition
+  const size_t threads = std::max<size_t>(1, std::min<size_t>(options.getIRThreads(), prototypes.size()));
+  vector<vector<const ASTNode*>> partitions(threads);
+  size_t next = 0;
+  for(const ASTNode* node: ast){
+    if (node->getNodeType() == ASTNodeType::FUNCTION)
+      partitions[next++ % threads].push_back(node);
+    else if (node->getNodeType() == ASTNodeType::STRUCTURE) {
+      node->accept(this);
+      for(vector<const ASTNode*>& partition: partitions)
+        partition.push_back(node);
+    }
+    else
+      node->accept(this);
+  }
+
+  // Modules can't be linked across contexts, every worker hands its module over as bitcode
+  vector<llvm::SmallVector<char, 0>> bitcodes(threads);
+  vector<std::thread> workers;
+  for(size_t index = 0; index < threads; index++){
+    workers.emplace_back([&, index](){
+      Codegen worker(partitions[index], prototypes, globals, options);
+      llvm::raw_svector_ostream output(bitcodes[index]);
+      llvm::WriteBitcodeToFile(*worker.getModule(), output);
+    });
+  }
+  for(std::thread& worker: workers)
+    worker.join();
+
+  llvm::Linker linker(*module);
+  for(const llvm::SmallVector<char, 0>& bitcode: bitcodes){
+    llvm::MemoryBufferRef buffer(llvm::StringRef(bitcode.data(), bitcode.size()), "partition");
+    llvm::Expected<unique_ptr<llvm::Module>> partition = llvm::parseBitcodeFile(buffer, context);
+    if (!partition)
+      error("Couldn't read back a module generated in parallel: " + llvm::toString(partition.takeError()));
+
+    if (linker.linkInModule(std::move(*partition)))
+      error("Couldn't link the modules generated in parallel");
+  }
+
+  for(const Function* prototype: prototypes)
+    functions.emplace(prototype, module->getFunction(prototype->getIdentifier()->toString()));
+}
+
+llvm::OptimizationLevel Codegen::getOptimizationLevel() const {
+  return ::getOptimizationLevel(options.getOptimizationLevel());
+}
+
+// --profile-generate adds the instrumentation and --profile-use the counts of a previous run to
+// the default pipelines: branch weights, hot and cold functions, inlining and block placement
+static std::optional<llvm::PGOOptions> getProfileOptions(const Options& options) {
+  llvm::PGOOptions::PGOAction action = llvm::PGOOptions::NoAction;
+  string path;
+  if (!options.getProfileGeneratePath().empty()) {
+    action = llvm::PGOOptions::IRInstr;
+    path = options.getProfileGeneratePath();
+  }
+  else if (!options.getProfileUsePath().empty()) {
+    action = llvm::PGOOptions::IRUse;
+    path = options.getProfileUsePath();
+    if (!llvm::sys::fs::exists(path))
+      error("Couldn't find the profile " + path);
+  }
+  else
+    return std::nullopt;
+
+#if LLVM_VERSION_MAJOR >= 17
+  return llvm::PGOOptions(path, "", "", "", llvm::vfs::getRealFileSystem(), action);
+#elif LLVM_VERSION_MAJOR >= 16
+  return llvm::PGOOptions(path, "", "", llvm::vfs::getRealFileSystem(), action);
+#else
+  return llvm::PGOOptions(path, "", "", action);
+#endif
+}
+
+void Codegen::optimize(){
+  // In parallel mode every function has already been optimized by its worker
+  if (options.getIRThreads() > 1)
+    return;
+
+  const llvm::OptimizationLevel level = getOptimizationLevel();
+#if LLVM_VERSION_MAJOR >= 16
+  llvm::PassBuilder passBuilder(targetMachine.get(), llvm::PipelineTuningOptions(), getProfileOptions(options));
+#else
+  std::optional<llvm::PGOOptions> profile = getProfileOptions(options);
+  llvm::PassBuilder passBuilder(targetMachine.get(), llvm::PipelineTuningOptions(), profile ? llvm::Optional<llvm::PGOOptions>(*profile) : llvm::None);
+#endif
+  AnalysisManagers managers(passBuilder);
+
+  llvm::ModulePassManager passes;
+  if (level == llvm::OptimizationLevel::O0) {
+    passes.addPass(llvm::createModuleToFunctionPassAdaptor(buildPromotionPipeline()));
+    passes.addPass(passBuilder.buildO0DefaultPipeline(level));
+  }
+  // The modules are optimized again once they're linked together
+  else if (options.isLinkTimeOptimized() && options.getLTOMode() == Options::LTO::THIN)
+    passes = passBuilder.buildThinLTOPreLinkDefaultPipeline(level);
+  else if (options.isLinkTimeOptimized())
+    passes = passBuilder.buildLTOPreLinkDefaultPipeline(level);
+  else
+    passes = passBuilder.buildPerModuleDefaultPipeline(level);
+  passes.run(*module, managers.module);
+}
+
+void Codegen::optimizeFunctions(){
+  const llvm::OptimizationLevel level = getOptimizationLevel();
+  llvm::PassBuilder passBuilder(targetMachine.get());
+  AnalysisManagers managers(passBuilder);
+
+  llvm::FunctionPassManager passes = level == llvm::OptimizationLevel::O0
+    ? buildPromotionPipeline()
+    : passBuilder.buildFunctionSimplificationPipeline(level, llvm::ThinOrFullLTOPhase::None);
+  for(llvm::Function& function: *module)
+    if (!function.isDeclaration())
+      passes.run(function, managers.function);
 }
 
 void Codegen::executeIR(){
-  llvm::InitializeNativeTarget();
-  llvm::InitializeNativeTargetAsmPrinter();
-  llvm::InitializeNativeTargetAsmParser();
+  executeModule(std::move(module), options);
+}
+
+void Codegen::executeModule(unique_ptr<llvm::Module> module, const Options& options){
+  ObjectEmitter::initializeTarget();
+
+  // Read before the JIT takes the module, the counters are found by name once main returns
+  std::optional<ProfileCollector> profile;
+  if (!options.getProfileGeneratePath().empty())
+    profile.emplace(*module);
+
+  // Run on the same CPU the module was optimized for
+  llvm::SmallVector<llvm::StringRef, 64> features;
+  const string hostFeatures = ObjectEmitter::getHostFeatures();
+  llvm::StringRef(hostFeatures).split(features, ',', -1, false);
 
   string error;
   llvm::ExecutionEngine* executionEngine = 
     llvm::EngineBuilder(std::move(module))
       .setErrorStr(&error)
+      .setMCPU(ObjectEmitter::getHostCPU())
+      .setMAttrs(vector<string>(features.begin(), features.end()))
       .setMCJITMemoryManager(std::make_unique<llvm::SectionMemoryManager>())
       .create();
 
@@ -27,6 +249,9 @@ void Codegen::executeIR(){
     return;
   }
 
+  // The runtime is linked into the compiler, the JIT doesn't look for it in the process by itself
+  llvm::sys::DynamicLibrary::AddSymbol(SHQ_PARALLEL_FOR, reinterpret_cast<void*>(&shq_parallel_for));
+
   executionEngine->finalizeObject();  // Ensure IR is compiled
 
   // Get the function pointer to "main" (or another function)
@@ -38,6 +263,9 @@ void Codegen::executeIR(){
 
   // Run the generated function
   mainFunction();
+
+  if (profile && !profile->isEmpty())
+    profile->write(*executionEngine, options.getProfileGeneratePath());
 }
 
 llvm::LLVMContext& Codegen::getContext(){
@@ -59,19 +287,22 @@ llvm::Type* Codegen::getLLVMType(const ASTNodeType type, const string& str_type
 
     case ASTNodeType::CHAR:
     case ASTNodeType::INT8:
+    case ASTNodeType::UINT8:
       return llvm::Type::getInt8Ty(context);
 
     case ASTNodeType::INT16:
+    case ASTNodeType::UINT16:
       return llvm::Type::getInt16Ty(context);
 
+    case ASTNodeType::INT:
     case ASTNodeType::INT32:
+    case ASTNodeType::UINT:
+    case ASTNodeType::UINT32:
       return llvm::Type::getInt32Ty(context);
 
     case ASTNodeType::INT64:
+    case ASTNodeType::UINT64:
       return llvm::Type::getInt64Ty(context);
-    
-    case ASTNodeType::INT:
-      return llvm::Type::getInt32Ty(context);
 
     case ASTNodeType::FLOAT32:
       return llvm::Type::getFloatTy(context);
@@ -82,31 +313,112 @@ llvm::Type* Codegen::getLLVMType(const ASTNodeType type, const string& str_type
     case ASTNodeType::FLOAT:
       return llvm::Type::getDoubleTy(context);
 
+    case ASTNodeType::INT32X4:
+    case ASTNodeType::INT32X8:
+    case ASTNodeType::INT64X2:
+    case ASTNodeType::INT64X4:
+    case ASTNodeType::FLOAT32X4:
+    case ASTNodeType::FLOAT32X8:
+    case ASTNodeType::FLOAT64X2:
+    case ASTNodeType::FLOAT64X4:
+      return llvm::FixedVectorType::get(getLLVMType(Type::GetElementType(type)), Type::GetLaneCount(type));
+
+    case ASTNodeType::INT_PTR:
+    case ASTNodeType::INT8_PTR:
+    case ASTNodeType::INT16_PTR:
+    case ASTNodeType::INT32_PTR:
+    case ASTNodeType::INT64_PTR:
+    case ASTNodeType::UINT_PTR:
+    case ASTNodeType::UINT8_PTR:
+    case ASTNodeType::UINT16_PTR:
+    case ASTNodeType::UINT32_PTR:
+    case ASTNodeType::UINT64_PTR:
+    case ASTNodeType::FLOAT_PTR:
+    case ASTNodeType::FLOAT32_PTR:
+    case ASTNodeType::FLOAT64_PTR:
+    case ASTNodeType::INT32X4_PTR:
+    case ASTNodeType::INT32X8_PTR:
+    case ASTNodeType::INT64X2_PTR:
+    case ASTNodeType::INT64X4_PTR:
+    case ASTNodeType::FLOAT32X4_PTR:
+    case ASTNodeType::FLOAT32X8_PTR:
+    case ASTNodeType::FLOAT64X2_PTR:
+    case ASTNodeType::FLOAT64X4_PTR:
+      return llvm::PointerType::get(getLLVMType(Type::GetPointeeType(type)), 0);
+
     case ASTNodeType::NOTHING:
       return llvm::Type::getVoidTy(context);
     
-    case ASTNodeType::IDENTIFIER:
-      return llvm::StructType::getTypeByName(context, str_type);
+    case ASTNodeType::IDENTIFIER: {
+      optional<IRStruct> structure = scope.findStruct(str_type);
+      return structure ? structure.value() : nullptr;
+    }
 
     default:
       error("Couldn't generate type to a valid LLVM Type");
   }
 }
 
-llvm::Value* Codegen::getLLVMValue(const ASTNode* value){
+// Only pointers have one, for the other types it's null
+llvm::Type* Codegen::getPointeeType(const ASTNodeType type) {
+  return Type::IsPointer(type) ? getLLVMType(Type::GetPointeeType(type)) : nullptr;
+}
+
+// Literals have no type of their own, when the expected type is known they're built
+// directly with it instead of being extended/truncated after the fact (with the
+// element type for vectors, the conversion to the expected type splats them)
+llvm::Value* Codegen::getLLVMValue(const ASTNode* value, llvm::Type* expected){
+  if (expected)
+    expected = expected->getScalarType();
+
+  // Folded by the semantic analysis, it has the type the operation would have produced
+  if (value->getConstant())
+    return generateConstant(*value->getConstant());
+
   switch(value->getNodeType()) {
-    case ASTNodeType::LITERAL_INTEGER:
-      return builder.getInt32(std::stoi(dynamic_cast<const Literal*>(value)->toString()));
+    case ASTNodeType::LITERAL_INTEGER: {
+      const string literal = dynamic_cast<const Literal*>(value)->toString();
+      const unsigned bits = std::max(1u, llvm::APInt::getBitsNeeded(literal, 10));
+      const llvm::APInt integer(bits, literal, 10);
 
-    case ASTNodeType::LITERAL_FLOAT:
-      return llvm::ConstantFP::get(llvm::Type::getFloatTy(context), std::stod(dynamic_cast<const Literal*>(value)->toString()));
+      // Negative literals are stored in the minimum bits as two's complement, so they're sign extended
+      const unsigned width = expected && expected->isIntegerTy() ? expected->getIntegerBitWidth() : bits > 32 ? 64 : 32;
+      return builder.getInt(literal[0] == '-' ? integer.sextOrTrunc(width) : integer.zextOrTrunc(width));
+    }
+
+    case ASTNodeType::LITERAL_FLOAT: {
+      llvm::Type* type = expected && expected->isFloatingPointTy() ? expected : llvm::Type::getDoubleTy(context);
+      return llvm::ConstantFP::get(type, dynamic_cast<const Literal*>(value)->toString());
+    }
 
     case ASTNodeType::LITERAL_CHARACTER:
-      return builder.getInt8(static_cast<int>(dynamic_cast<const Literal*>(value)->toString()[0]));
+      return builder.getInt8(static_cast<int>(dynamic_cast<const Literal*>(value)->toString()[1])); // [0] is the opening quote
 
     case ASTNodeType::LITERAL_BOOLEAN:
       return builder.getInt1(dynamic_cast<const Literal*>(value)->toString()[0] == 't'); // if it's t is' true other wise it's false (first char aren't equals)
 
+    case ASTNodeType::IDENTIFIER: {
+      const string name = dynamic_cast<const Identifier*>(value)->toString();
+      optional<IRVariable> variable = findVariable(name);
+      if (!variable)
+        error("Couldn't find the variable " + name + " while generating IR");
+      return builder.CreateLoad(variable->type, variable->address, name);
+    }
+
+    case ASTNodeType::INDEX_OPERATOR: {
+      const IndexOperator* indexOperator = dynamic_cast<const IndexOperator*>(value);
+      const string name = indexOperator->getIdentifier()->toString();
+      llvm::Type* elementType = nullptr;
+      llvm::Value* element = generateElementPointer(name, indexOperator->getIndex(), indexOperator->getIndexType(), elementType);
+      return builder.CreateLoad(elementType, element, name + ".element");
+    }
+
+    case ASTNodeType::DOT_OPERATOR: {
+      const DotOperator* dotOperator = dynamic_cast<const DotOperator*>(value);
+      const Member member = generateMemberPointer(dotOperator);
+      return builder.CreateAlignedLoad(member.type, member.address, member.alignment, dotOperator->getIdentifier()->toString() + "." + dotOperator->getMember());
+    }
+
     case ASTNodeType::BINARY_OPERATOR:
       return generateBinaryOperator(dynamic_cast<const BinaryOperator*>(value));
 
@@ -116,87 +428,200 @@ llvm::Value* Codegen::getLLVMValue(const ASTNode* value){
     case ASTNodeType::CAST:
       return generateCast(dynamic_cast<const Cast*>(value));
 
+    case ASTNodeType::FUNCTION_CALL: {
+      const FunctionCall* functionCall = dynamic_cast<const FunctionCall*>(value);
+      if (functionCall->isBuiltin())
+        return generateBuiltin(functionCall);
+      return generateCall(functionCall);
+    }
+
     default:
       error("Couldn't convert expression to a valid LLVM Value");
   }
 }
 
+llvm::Constant* Codegen::generateConstant(const Constant& constant) {
+  llvm::Type* type = getLLVMType(constant.type);
+  if (constant.isFloat())
+    return llvm::ConstantFP::get(type, constant.floating);
+  return llvm::ConstantInt::get(type, constant.integer);
+}
+
 llvm::Value* Codegen::generateBinaryOperator(const BinaryOperator* statement) {
   // #[DEBUG]
   if (statement == nullptr) {
     error("statement is null");
   }
 
+  if (statement->getOperator() == TokenType::AND || statement->getOperator() == TokenType::OR)
+    return generateLogicalOperator(statement);
+
+  // Both operands are brought to the common type computed by the semantic analysis
+  const ASTNodeType operandType = statement->getOperandType();
+  llvm::Type* type = getLLVMType(operandType);
+
+  llvm::Value* left = generateConversion(getLLVMValue(statement->getLeft(), type), statement->getLeftType(), type);
+  llvm::Value* right = generateConversion(getLLVMValue(statement->getRight(), type), statement->getRightType(), type);
+  return generateOperation(statement->getOperator(), left, right, Type::IsUnsigned(operandType));
+}
+
+// Whether an expression can be evaluated even when the program wouldn't: it can't trap, write
+// memory or call anything, and it's cheap. Elements and members aren't, the condition on the
+// left is often the one that keeps the index in bounds
+static bool isSpeculatable(const ASTNode* value, unsigned& budget) {
+  if (value->getConstant())
+    return true;
+  if (budget == 0)
+    return false;
+  budget--;
+
+  switch (value->getNodeType()) {
+    case ASTNodeType::LITERAL_INTEGER:
+    case ASTNodeType::LITERAL_FLOAT:
+    case ASTNodeType::LITERAL_CHARACTER:
+    case ASTNodeType::LITERAL_BOOLEAN:
+    case ASTNodeType::IDENTIFIER:
+      return true;
+
+    case ASTNodeType::CAST:
+      return isSpeculatable(dynamic_cast<const Cast*>(value)->getExpression(), budget);
+
+    case ASTNodeType::UNARY_OPERATOR: {
+      const UnaryOperator* unaryOperator = dynamic_cast<const UnaryOperator*>(value);
+      return unaryOperator->getOperator() == TokenType::NOT && isSpeculatable(unaryOperator->getRight(), budget);
+    }
+
+    case ASTNodeType::BINARY_OPERATOR: {
+      const BinaryOperator* binaryOperator = dynamic_cast<const BinaryOperator*>(value);
+      const bool isDivision = binaryOperator->getOperator() == TokenType::DIVISION || binaryOperator->getOperator() == TokenType::MODULUS;
+      const bool canTrap = isDivision && !Constant{ binaryOperator->getOperandType() }.isFloat();
+      return !canTrap && isSpeculatable(binaryOperator->getLeft(), budget) && isSpeculatable(binaryOperator->getRight(), budget);
+    }
+
+    default:
+      return false;
+  }
+}
+
+// The right operand only runs when the left one doesn't decide the result. When it's cheap
+// and safe to run anyway both are evaluated and a select picks the result, a branch the
+// predictor misses costs more than the few instructions it saves
+llvm::Value* Codegen::generateLogicalOperator(const BinaryOperator* statement) {
+  static constexpr unsigned SPECULATION_LIMIT = 4; // nodes evaluated without a branch
+
+  const bool isOr = statement->getOperator() == TokenType::OR;
   llvm::Value* left = getLLVMValue(statement->getLeft());
+
+  unsigned budget = SPECULATION_LIMIT;
+  if (isSpeculatable(statement->getRight(), budget)) {
+    llvm::Value* right = getLLVMValue(statement->getRight());
+    return isOr ? builder.CreateSelect(left, builder.getTrue(), right, "or") : builder.CreateSelect(left, right, builder.getFalse(), "and");
+  }
+
+  llvm::Function* function = builder.GetInsertBlock()->getParent();
+  llvm::BasicBlock* leftBlock = builder.GetInsertBlock();
+  llvm::BasicBlock* rightBlock = llvm::BasicBlock::Create(context, isOr ? "or.rhs" : "and.rhs", function);
+  llvm::BasicBlock* endBlock = llvm::BasicBlock::Create(context, isOr ? "or.end" : "and.end", function);
+
+  if (isOr)
+    builder.CreateCondBr(left, endBlock, rightBlock);
+  else
+    builder.CreateCondBr(left, rightBlock, endBlock);
+
+  // The right operand can add blocks of its own, like the ones of a bounds check
+  builder.SetInsertPoint(rightBlock);
   llvm::Value* right = getLLVMValue(statement->getRight());
-  const TokenType op = statement->getOperator();
-  
+  rightBlock = builder.GetInsertBlock();
+  builder.CreateBr(endBlock);
+
+  builder.SetInsertPoint(endBlock);
+  llvm::PHINode* result = builder.CreatePHI(builder.getInt1Ty(), 2, isOr ? "or" : "and");
+  result->addIncoming(builder.getInt1(isOr), leftBlock);
+  result->addIncoming(right, rightBlock);
+  return result;
+}
+
+llvm::Value* Codegen::generateOperation(const TokenType op, llvm::Value* left, llvm::Value* right, const bool isUnsigned) {
+  const bool isFloat = left->getType()->isFPOrFPVectorTy();
+
   switch (op) {
     case TokenType::EQUALS:
-      if (left->getType()->isFloatTy() && right->getType()->isFloatTy()) 
+      if (isFloat) 
         return builder.CreateFCmpUEQ(left, right, "cmptmp");
       else 
         return builder.CreateICmpEQ(left, right, "cmptmp");
     
     case TokenType::NOT_EQUAL:
-      if (left->getType()->isFloatTy() && right->getType()->isFloatTy()) 
+      if (isFloat) 
         return builder.CreateFCmpUNE(left, right, "cmptmp");
       else 
         return builder.CreateICmpNE(left, right, "cmptmp");
     
     case TokenType::GREATER:
-      if (left->getType()->isFloatTy() && right->getType()->isFloatTy()) 
+      if (isFloat) 
         return builder.CreateFCmpUGT(left, right, "cmptmp");
+      else if (isUnsigned)
+        return builder.CreateICmpUGT(left, right, "cmptmp");
       else 
         return builder.CreateICmpSGT(left, right, "cmptmp");
     
     case TokenType::LESS:
-      if (left->getType()->isFloatTy() && right->getType()->isFloatTy()) 
+      if (isFloat) 
         return builder.CreateFCmpULT(left, right, "cmptmp");
+      else if (isUnsigned)
+        return builder.CreateICmpULT(left, right, "cmptmp");
       else 
         return builder.CreateICmpSLT(left, right, "cmptmp");
     
     case TokenType::GREATER_EQUAL:
-      if (left->getType()->isFloatTy() && right->getType()->isFloatTy()) 
+      if (isFloat) 
         return builder.CreateFCmpUGE(left, right, "cmptmp");
+      else if (isUnsigned)
+        return builder.CreateICmpUGE(left, right, "cmptmp");
       else 
-        return builder.CreateICmpSLE(left, right, "cmptmp");
+        return builder.CreateICmpSGE(left, right, "cmptmp");
     
     case TokenType::LESS_EQUAL:
-      if (left->getType()->isFloatTy() && right->getType()->isFloatTy()) 
+      if (isFloat) 
         return builder.CreateFCmpULE(left, right, "cmptmp");
+      else if (isUnsigned)
+        return builder.CreateICmpULE(left, right, "cmptmp");
       else 
         return builder.CreateICmpSLE(left, right, "cmptmp");
     
     case TokenType::ADDITION:
-      if (left->getType()->isFloatTy() && right->getType()->isFloatTy()) 
+      if (isFloat) 
         return builder.CreateFAdd(left, right, "faddtmp");
       else 
         return builder.CreateAdd(left, right, "addtmp");
     
     case TokenType::SUBTRACTION:
-      if (left->getType()->isFloatTy() && right->getType()->isFloatTy()) 
-        return builder.CreateFSub(left, right, "faddtmp");
+      if (isFloat) 
+        return builder.CreateFSub(left, right, "fsubtmp");
       else 
-        return builder.CreateSub(left, right, "addtmp");
+        return builder.CreateSub(left, right, "subtmp");
     
     case TokenType::STAR:
-      if (left->getType()->isFloatTy() && right->getType()->isFloatTy()) 
-        return builder.CreateFMul(left, right, "faddtmp");
+      if (isFloat) 
+        return builder.CreateFMul(left, right, "fmultmp");
       else 
-        return builder.CreateMul(left, right, "addtmp");
+        return builder.CreateMul(left, right, "multmp");
     
     case TokenType::DIVISION:
-      if (left->getType()->isFloatTy() && right->getType()->isFloatTy()) 
-        return builder.CreateFDiv(left, right, "faddtmp");
+      if (isFloat) 
+        return builder.CreateFDiv(left, right, "fdivtmp");
+      else if (isUnsigned)
+        return builder.CreateUDiv(left, right, "divtmp");
       else 
-        return builder.CreateSDiv(left, right, "addtmp");
+        return builder.CreateSDiv(left, right, "divtmp");
     
     case TokenType::MODULUS:
-      if (left->getType()->isFloatTy() && right->getType()->isFloatTy()) 
-        return builder.CreateFRem(left, right, "faddtmp");
+      if (isFloat) 
+        return builder.CreateFRem(left, right, "fremtmp");
+      else if (isUnsigned)
+        return builder.CreateURem(left, right, "remtmp");
       else 
-        return builder.CreateSRem(left, right, "addtmp");
+        return builder.CreateSRem(left, right, "remtmp");
     
     default:
       error("Invalid operator in binary operation");   
@@ -209,22 +634,38 @@ llvm::Value* Codegen::generateUnaryOperator(const UnaryOperator* statement){
     error("statement is null");
   }
 
-  llvm::Value* right = getLLVMValue(statement->getRight());
   const TokenType op = statement->getOperator();
+  if (op == TokenType::AMPERSAND)
+    return generateAddress(statement->getRight());
+
+  llvm::Value* right = getLLVMValue(statement->getRight());
 
   switch (op) {
     case TokenType::NOT:
       return builder.CreateICmpEQ(right, llvm::ConstantInt::get(right->getType(), 0));
 
-    case TokenType::AMPERSAND:
     case TokenType::CARET:
-      error("Implement pointers in unary operator"); // TODO Add pointer dereference
+      return builder.CreateLoad(getLLVMType(statement->getType()), right, "dereference");
     
     default:
       error("Invalid operator in unary operator");
   }
 }
 
+// The semantic analysis only lets through variables, parameters and array elements
+llvm::Value* Codegen::generateAddress(const ASTNode* value) {
+  if (const IndexOperator* indexOperator = dynamic_cast<const IndexOperator*>(value)) {
+    llvm::Type* elementType = nullptr;
+    return generateElementPointer(indexOperator->getIdentifier()->toString(), indexOperator->getIndex(), indexOperator->getIndexType(), elementType);
+  }
+
+  const string name = dynamic_cast<const Identifier*>(value)->toString();
+  optional<IRVariable> variable = findVariable(name);
+  if (!variable)
+    error("Couldn't find the variable " + name + " while generating IR");
+  return variable->address;
+}
+
 llvm::Value* Codegen::generateCast(const Cast* statement){
   // #[DEBUG]
   if (statement == nullptr) {
@@ -233,32 +674,92 @@ llvm::Value* Codegen::generateCast(const Cast* statement){
 
   llvm::Type* castType = getLLVMType(statement->getType());
   llvm::Value* value = getLLVMValue(statement->getExpression());
-  llvm::Type* valueType = value->getType();  
-
-  if (valueType->isIntegerTy() && castType->isFloatTy())
-    return builder.CreateSIToFP(value, castType, "intToFloat");
+  return generateConversion(value, statement->getExpressionType(), castType, Type::IsUnsigned(statement->getType()));
+}
 
-  else if (valueType->isFloatTy() && castType == llvm::Type::getInt32Ty(context))
-    return builder.CreateFPToSI(value, castType, "floatToInt");
+// The signedness of the source decides between sign and zero extension, the one
+// of the target is only needed when converting floats to integers. Vectors are
+// converted lane by lane, a scalar converted to a vector is broadcast to every lane
+llvm::Value* Codegen::generateConversion(llvm::Value* value, const ASTNodeType from, llvm::Type* to, const bool isTargetUnsigned){
+  llvm::Type* valueType = value->getType();
+  if (valueType == to)
+    return value;
 
-  else if (valueType == llvm::Type::getInt8Ty(context) && castType == llvm::Type::getInt32Ty(context))
-    return builder.CreateZExt(value, castType, "charToInt");
+  if (to->isVectorTy() && !valueType->isVectorTy()) {
+    llvm::Value* element = generateConversion(value, from, to->getScalarType(), isTargetUnsigned);
+    return builder.CreateVectorSplat(llvm::cast<llvm::VectorType>(to)->getElementCount(), element, "splat");
+  }
 
-  else if (valueType == llvm::Type::getInt32Ty(context) && castType == llvm::Type::getInt8Ty(context))
-    return builder.CreateTrunc(value, castType, "intToChar");
+  const bool isSourceUnsigned = Type::IsUnsigned(from);
 
-  else if (valueType->isIntegerTy() && castType == llvm::Type::getInt1Ty(context))
+  if (to->isIntegerTy(1)) {
+    if (valueType->isFloatingPointTy())
+      return builder.CreateFCmpONE(value, llvm::ConstantFP::get(valueType, 0.0), "floatToBool");
     return builder.CreateICmpNE(value, llvm::ConstantInt::get(valueType, 0), "intToBool");
-  
-  else if (valueType == llvm::Type::getInt1Ty(context) && castType->isIntegerTy())
-    return builder.CreateZExt(value, castType, "boolToInt");
-  
-  else if (valueType->isFloatTy() && castType == llvm::Type::getInt1Ty(context))
-    return builder.CreateFCmpONE(value, llvm::ConstantFP::get(valueType, 0.0), "floatToBool");
-  
-  else {
-    error("Couldn't generate a cast expression");
   }
+
+  if (valueType->isIntOrIntVectorTy() && to->isIntOrIntVectorTy())
+    return isSourceUnsigned 
+      ? builder.CreateZExtOrTrunc(value, to, "intCast") 
+      : builder.CreateSExtOrTrunc(value, to, "intCast");
+
+  if (valueType->isIntOrIntVectorTy() && to->isFPOrFPVectorTy())
+    return isSourceUnsigned 
+      ? builder.CreateUIToFP(value, to, "intToFloat") 
+      : builder.CreateSIToFP(value, to, "intToFloat");
+
+  if (valueType->isFPOrFPVectorTy() && to->isIntOrIntVectorTy())
+    return isTargetUnsigned 
+      ? builder.CreateFPToUI(value, to, "floatToInt") 
+      : builder.CreateFPToSI(value, to, "floatToInt");
+
+  if (valueType->isFPOrFPVectorTy() && to->isFPOrFPVectorTy())
+    return builder.CreateFPCast(value, to, "floatCast");
+
+  error("Couldn't generate a cast expression");
+}
+
+// Lanes of extract and shuffle are integer literals checked by the semantic analysis
+llvm::Value* Codegen::generateBuiltin(const FunctionCall* statement){
+  const string name = statement->getName();
+  const vector<Expression*> arguments = statement->getArguments();
+  llvm::Value* source = getLLVMValue(arguments[0]->getASTNode());
+  const bool isFloat = source->getType()->isFPOrFPVectorTy();
+
+  auto getLane = [](const Expression* argument) -> uint64_t {
+    return std::stoull(dynamic_cast<const Literal*>(argument->getASTNode())->toString());
+  };
+
+  if (name == "extract")
+    return builder.CreateExtractElement(source, builder.getInt64(getLane(arguments[1])), "extract");
+
+  if (name == "shuffle") {
+    const bool hasSecondVector = Type::IsVector(arguments[1]->getType());
+    llvm::Value* second = hasSecondVector ? getLLVMValue(arguments[1]->getASTNode()) : llvm::PoisonValue::get(source->getType());
+
+    vector<int> mask;
+    for (size_t index = hasSecondVector ? 2 : 1; index < arguments.size(); index++)
+      mask.push_back(static_cast<int>(getLane(arguments[index])));
+    return builder.CreateShuffleVector(source, second, mask, "shuffle");
+  }
+
+  // Floating point reductions may reassociate the lanes, otherwise they'd be a serial chain
+  llvm::Type* elementType = source->getType()->getScalarType();
+  llvm::CallInst* reduction = nullptr;
+  if (name == "reduce_add")
+    reduction = isFloat ? builder.CreateFAddReduce(llvm::ConstantFP::getNegativeZero(elementType), source) : builder.CreateAddReduce(source);
+  else if (name == "reduce_mul")
+    reduction = isFloat ? builder.CreateFMulReduce(llvm::ConstantFP::get(elementType, 1.0), source) : builder.CreateMulReduce(source);
+  else if (name == "reduce_min")
+    reduction = isFloat ? builder.CreateFPMinReduce(source) : builder.CreateIntMinReduce(source, true);
+  else if (name == "reduce_max")
+    reduction = isFloat ? builder.CreateFPMaxReduce(source) : builder.CreateIntMaxReduce(source, true);
+  else
+    error("Unknown builtin " + name);
+
+  if (isFloat)
+    reduction->setHasAllowReassoc(true);
+  return reduction;
 }
 
 vector<llvm::Type*> Codegen::getParametersType(const vector<Parameter*>& parameters){
@@ -271,29 +772,303 @@ vector<llvm::Type*> Codegen::getParametersType(const vector<Parameter*>& paramet
   return types;
 }
 
-void Codegen::visit(const AssignmentOperator* statement) { statement->print(); }
+void Codegen::visit(const Annotation* statement) { statement->print(); }
+
+void Codegen::visit(const AssignmentOperator* statement) {
+  const string name = statement->getIdentifier()->toString();
+  llvm::Type* type = nullptr;
+  llvm::Value* address = nullptr;
+
+  if (statement->isIndexed())
+    address = generateElementPointer(name, statement->getIndex(), statement->getIndexType(), type);
+  else {
+    optional<IRVariable> variable = findVariable(name);
+    if (!variable)
+      error("Couldn't find the variable " + name + " while generating IR");
+    address = variable->address;
+    type = variable->type;
+
+    // ^pointer = value stores where the pointer points
+    if (statement->isDereference()) {
+      address = builder.CreateLoad(variable->type, variable->address, name);
+      type = variable->pointee;
+    }
+  }
+
+  generateAssignment(statement, address, type, statement->getIdentifierType());
+}
+
+// Compound assignments load the current value and apply the operation with the signedness of the target
+void Codegen::generateAssignment(const AssignmentOperator* statement, llvm::Value* address, llvm::Type* type, const ASTNodeType targetType, const llvm::MaybeAlign alignment) {
+  llvm::Value* value = generateConversion(getLLVMValue(statement->getExpression(), type), statement->getExpressionType(), type);
+
+  TokenType op;
+  switch (statement->getOperator()) {
+    case TokenType::ASSIGNMENT:
+      builder.CreateAlignedStore(value, address, alignment);
+      return;
+
+    case TokenType::ADDITION_ASSIGNMENT:
+      op = TokenType::ADDITION;
+      break;
+
+    case TokenType::SUBTRACTION_ASSIGNMENT:
+      op = TokenType::SUBTRACTION;
+      break;
+
+    case TokenType::MULTIPLICATION_ASSIGNMENT:
+      op = TokenType::STAR;
+      break;
+
+    case TokenType::DIVISION_ASSIGNMENT:
+      op = TokenType::DIVISION;
+      break;
+
+    case TokenType::MODULUS_ASSIGNMENT:
+      op = TokenType::MODULUS;
+      break;
+
+    default:
+      error("Invalid operator in assignment operator");
+  }
+
+  llvm::Value* current = builder.CreateAlignedLoad(type, address, alignment, statement->getIdentifier()->toString());
+  builder.CreateAlignedStore(generateOperation(op, current, value, Type::IsUnsigned(targetType)), address, alignment);
+}
+
 void Codegen::visit(const BinaryOperator* statement) { statement->print(); }
 void Codegen::visit(const Body* statement) { statement->print(); }
 void Codegen::visit(const Cast* statement) { statement->print(); }
-void Codegen::visit(const DotOperator* statement) { statement->print(); }
-void Codegen::visit(const DoWhile* statement) { statement->print(); }
-void Codegen::visit(const Else* statement) { statement->print(); }
+void Codegen::visit(const DotOperator* statement) {
+  const Member member = generateMemberPointer(statement);
+  generateAssignment(statement->getAssignment(), member.address, member.type, statement->getMemberType(statement), member.alignment);
+}
+
+
+void Codegen::visit(const Else* statement) {
+  if (const If* elseIf = statement->getIf())
+    elseIf->accept(this);
+  else
+    generateBody(statement->getBody());
+}
 void Codegen::visit(const Expression* statement) {
   statement->print(); 
 }
-void Codegen::visit(const For* statement) { statement->print(); }
 
-void Codegen::visit(const Function* statement) {
-  const ASTNodeType AST_ReturnType = statement->getType();
-  const Identifier* AST_Identifier = statement->getIdentifier();
-  const vector<Parameter*> AST_Parameters = statement->getParameter();
-  const vector<ASTNode*> AST_Body = statement->getBody();
 
-  llvm::Type* IR_ReturnType = getLLVMType(AST_ReturnType);
-  vector<llvm::Type*> IR_Parameters = getParametersType(AST_Parameters);
+
+llvm::Function* Codegen::declareFunction(const Function* statement) {
+  auto declared = functions.find(statement);
+  if (declared != functions.end())
+    return declared->second;
+  const string name = statement->getIdentifier()->toString();
+
+  llvm::Type* IR_ReturnType = getLLVMType(statement->getType());
+  vector<llvm::Type*> IR_Parameters = getParametersType(statement->getParameter());
   llvm::FunctionType* IR_type = llvm::FunctionType::get(IR_ReturnType, IR_Parameters, false);
 
-  llvm::Function* function = llvm::Function::Create(IR_type, llvm::Function::ExternalLinkage, AST_Identifier->toString(), module.get());
+  llvm::Function* function = llvm::Function::Create(IR_type, llvm::Function::ExternalLinkage, name, module.get());
+  functions.emplace(statement, function);
+
+  if (statement->findAnnotation("inline") && statement->findAnnotation("noinline"))
+    error("Function " + name + " can't be both #inline and #noinline");
+  if (statement->findAnnotation("hot") && statement->findAnnotation("cold"))
+    error("Function " + name + " can't be both #hot and #cold");
+
+  if (statement->findAnnotation("inline"))
+    function->addFnAttr(llvm::Attribute::AlwaysInline);
+  if (statement->findAnnotation("noinline"))
+    function->addFnAttr(llvm::Attribute::NoInline);
+  if (statement->findAnnotation("hot"))
+    function->addFnAttr(llvm::Attribute::Hot);
+  if (statement->findAnnotation("cold"))
+    function->addFnAttr(llvm::Attribute::Cold);
+
+  // restrict promises the memory isn't reached through any other pointer while the function
+  // runs, so the vectorizer doesn't need runtime checks for overlapping pointers
+  const vector<Parameter*> parameters = statement->getParameter();
+  for (size_t index = 0; index < parameters.size(); index++)
+    if (parameters[index]->isRestrict())
+      function->addParamAttr(index, llvm::Attribute::NoAlias);
+  return function;
+}
+
+// Only main and the #export functions and globals are visible outside of the module, the others
+// get internal linkage so the inliner knows every caller and drops them once they're all inlined,
+// and the optimizer knows every store to a global. It's done once the module is complete, the
+// partitions generated in parallel link through external names. Functions declared without a
+// body are defined by another module, which has to #export them
+void Codegen::internalizeSymbols(){
+  for(const ASTNode* node: ast){
+    const Function* statement = dynamic_cast<const Function*>(node);
+    if (!statement || statement->isExternal() || statement->getIdentifier()->toString() == "main" || statement->findAnnotation("export"))
+      continue;
+    if (llvm::Function* function = module->getFunction(statement->getIdentifier()->toString()))
+      function->setLinkage(llvm::GlobalValue::InternalLinkage);
+  }
+
+  for(llvm::GlobalVariable* global: internalGlobals)
+    global->setLinkage(llvm::GlobalValue::InternalLinkage);
+}
+
+// Distinct self referencing node that identifies the loop, followed by the hints
+// coming from its annotations: #vectorize(N) and #unroll(N), N being optional
+llvm::MDNode* Codegen::getLoopMetadata(const Annotated* loop) {
+  vector<llvm::Metadata*> operands = { nullptr };
+
+  auto hint = [this](const string& name, llvm::Constant* value) -> llvm::Metadata* {
+    vector<llvm::Metadata*> hint = { llvm::MDString::get(context, name) };
+    if (value)
+      hint.push_back(llvm::ConstantAsMetadata::get(value));
+    return llvm::MDNode::get(context, hint);
+  };
+
+  if (const Annotation* vectorize = loop->findAnnotation("vectorize")) {
+    operands.push_back(hint("llvm.loop.vectorize.enable", builder.getTrue()));
+    if (vectorize->getArgument())
+      operands.push_back(hint("llvm.loop.vectorize.width", builder.getInt32(vectorize->getArgument().value())));
+  }
+
+  if (const Annotation* unroll = loop->findAnnotation("unroll")) {
+    if (unroll->getArgument())
+      operands.push_back(hint("llvm.loop.unroll.count", builder.getInt32(unroll->getArgument().value())));
+    else
+      operands.push_back(hint("llvm.loop.unroll.enable", nullptr));
+  }
+
+  llvm::MDNode* metadata = llvm::MDNode::getDistinct(context, operands);
+  metadata->replaceOperandWith(0, metadata);
+  return metadata;
+}
+
+// #likely and #unlikely use the same weights as __builtin_expect, enough for the block
+// placement to keep the expected side as the fall-through and move the other one away
+llvm::MDNode* Codegen::getBranchWeights(const Annotated* statement) {
+  static constexpr uint32_t LIKELY_WEIGHT = 2000;
+  static constexpr uint32_t UNLIKELY_WEIGHT = 1;
+
+  const bool isLikely = statement->findAnnotation("likely");
+  const bool isUnlikely = statement->findAnnotation("unlikely");
+  if (isLikely && isUnlikely)
+    error("An if can't be both #likely and #unlikely");
+
+  if (isLikely)
+    return llvm::MDBuilder(context).createBranchWeights(LIKELY_WEIGHT, UNLIKELY_WEIGHT);
+  if (isUnlikely)
+    return llvm::MDBuilder(context).createBranchWeights(UNLIKELY_WEIGHT, LIKELY_WEIGHT);
+  return nullptr;
+}
+
+llvm::Value* Codegen::generateElementPointer(const string& name, const ASTNode* index, const ASTNodeType indexType, llvm::Type*& elementType) {
+  optional<IRVariable> variable = findVariable(name);
+  if (!variable)
+    error("Couldn't find the array " + name + " while generating IR");
+
+  llvm::Type* indexLLVMType = builder.getInt64Ty();
+  llvm::Value* position = generateConversion(getLLVMValue(index, indexLLVMType), indexType, indexLLVMType);
+
+  // The size of what a pointer points to isn't known, so there's nothing to check it against
+  if (variable->pointee) {
+    elementType = variable->pointee;
+    llvm::Value* pointer = builder.CreateLoad(variable->type, variable->address, name);
+    return builder.CreateInBoundsGEP(elementType, pointer, position, name + ".address");
+  }
+
+  llvm::ArrayType* arrayType = llvm::cast<llvm::ArrayType>(variable->type);
+  elementType = arrayType->getElementType();
+
+  if (options.areBoundsChecksEnabled())
+    generateBoundsCheck(position, arrayType->getNumElements());
+
+  return builder.CreateInBoundsGEP(arrayType, variable->address, { builder.getInt64(0), position }, name + ".address");
+}
+
+// A single unsigned compare also rejects negative indices. The failing path is a
+// noreturn trap, so once the optimizer proves the index range the whole check folds away
+void Codegen::generateBoundsCheck(llvm::Value* index, const uint64_t size) {
+  if (llvm::ConstantInt* constant = llvm::dyn_cast<llvm::ConstantInt>(index))
+    if (constant->getZExtValue() < size)
+      return;
+
+  llvm::Function* function = builder.GetInsertBlock()->getParent();
+  llvm::BasicBlock* failBlock = llvm::BasicBlock::Create(context, "bounds.fail", function);
+  llvm::BasicBlock* continueBlock = llvm::BasicBlock::Create(context, "bounds.ok", function);
+
+  llvm::Value* isInBounds = builder.CreateICmpULT(index, builder.getInt64(size), "bounds.check");
+  llvm::MDNode* weights = llvm::MDBuilder(context).createBranchWeights(1 << 20, 1);
+  builder.CreateCondBr(isInBounds, continueBlock, failBlock, weights);
+
+  builder.SetInsertPoint(failBlock);
+  builder.CreateIntrinsic(llvm::Intrinsic::trap, {}, {});
+  builder.CreateUnreachable();
+
+  builder.SetInsertPoint(continueBlock);
+}
+
+// Members of #soa arrays are arrays of their own, declared as `array.member`, the other
+// array elements are structs like any other
+Codegen::Member Codegen::generateMemberPointer(const DotOperator* statement) {
+  const string name = statement->getIdentifier()->toString();
+  const string member = statement->getMember();
+  if (!statement->isIndexed())
+    return generateMemberPointer(name, member);
+
+  llvm::Type* elementType = nullptr;
+  if (findVariable(name + "." + member)) {
+    llvm::Value* address = generateElementPointer(name + "." + member, statement->getIndex(), statement->getIndexType(), elementType);
+    return { address, elementType, module->getDataLayout().getABITypeAlign(elementType) };
+  }
+
+  llvm::Value* element = generateElementPointer(name, statement->getIndex(), statement->getIndexType(), elementType);
+  return generateMemberPointer(element, llvm::cast<llvm::StructType>(elementType), name, member);
+}
+
+Codegen::Member Codegen::generateMemberPointer(const string& name, const string& member) {
+  optional<IRVariable> variable = findVariable(name);
+  if (!variable)
+    error("Couldn't find the struct " + name + " while generating IR");
+  return generateMemberPointer(variable->address, llvm::cast<llvm::StructType>(variable->type), name, member);
+}
+
+// The alignment is the one guaranteed by the struct alignment at the offset of the member,
+// for #packed structs it can be as low as a single byte
+Codegen::Member Codegen::generateMemberPointer(llvm::Value* address, llvm::StructType* structType, const string& name, const string& member) {
+  optional<unsigned int> index = scope.findStructMemberIndex(structType, member);
+  optional<uint64_t> alignment = scope.findStructAlignment(structType);
+  if (!index || !alignment)
+    error("Couldn't find the member " + name + "." + member + " while generating IR");
+
+  const uint64_t offset = module->getDataLayout().getStructLayout(structType)->getElementOffset(index.value());
+  llvm::Value* memberAddress = builder.CreateStructGEP(structType, address, index.value(), name + "." + member);
+  return { memberAddress, structType->getElementType(index.value()), llvm::commonAlignment(llvm::Align(alignment.value()), offset) };
+}
+
+llvm::AllocaInst* Codegen::createEntryBlockAlloca(llvm::Type* type, const string& name) {
+  // Allocas outside the entry block would grow the stack on every loop iteration
+  // and aren't promoted to registers by mem2reg/SROA
+  llvm::BasicBlock& entry = builder.GetInsertBlock()->getParent()->getEntryBlock();
+  llvm::IRBuilder<> entryBuilder(&entry, entry.begin());
+  return entryBuilder.CreateAlloca(type, nullptr, name);
+}
+
+void Codegen::generateBody(const vector<ASTNode*>& body) {
+  scope.enterScope();
+  for(const ASTNode* node: body){
+    // Anything after a return, break or continue is unreachable
+    if (builder.GetInsertBlock()->getTerminator())
+      break;
+    node->accept(this);
+  }
+  scope.exitScope();
+}
+
+void Codegen::visit(const Function* statement) {
+  const vector<Parameter*> AST_Parameters = statement->getParameter();
+  llvm::Function* function = declareFunction(statement);
+  if (statement->isExternal())
+    return;
+
+  const vector<ASTNode*> AST_Body = statement->getBody();
   llvm::BasicBlock* BB = llvm::BasicBlock::Create(context, "entry", function);
   builder.SetInsertPoint(BB);
 
@@ -304,45 +1079,655 @@ void Codegen::visit(const Function* statement) {
     const Parameter* parameter = AST_Parameters.at(index);
     argument.setName(parameter->getIdentifier());
     
-    llvm::AllocaInst* variable = builder.CreateAlloca(argument.getType(), nullptr, parameter->getIdentifier() + "_addr");
+    llvm::AllocaInst* variable = createEntryBlockAlloca(argument.getType(), parameter->getIdentifier() + "_addr");
     builder.CreateStore(&argument, variable);
-    scope.declareVariable(parameter->getIdentifier(), variable);
+    scope.declareVariable(parameter->getIdentifier(), IRVariable{ variable, variable->getAllocatedType(), getPointeeType(parameter->getType()) });
     
     index++;
   }
 
-  for(const ASTNode* node: AST_Body){
-    node->accept(this);
-  }
+  generateBody(AST_Body);
 
   scope.exitScope();
 
-  scope.declareFunction(AST_Identifier->toString(), function);
+  if (!builder.GetInsertBlock()->getTerminator()) {
+    if (function->getReturnType()->isVoidTy())
+      builder.CreateRetVoid();
+    else
+      builder.CreateUnreachable();
+  }
+  builder.ClearInsertionPoint();
+
   llvm::verifyFunction(*function);
 }
 
-void Codegen::visit(const FunctionCall* statement) { statement->print(); }
+// A call used as a statement, its result is discarded. Folded const fn calls have no effect
+void Codegen::visit(const FunctionCall* statement) {
+  if (statement->getConstant())
+    return;
+  if (statement->isBuiltin())
+    generateBuiltin(statement);
+  else
+    generateCall(statement);
+}
+
+// The callee is the function the semantic analysis bound the call to, it's never looked up by
+// name. Arguments are converted to the parameter types, like the value of an assignment
+llvm::CallInst* Codegen::generateCall(const FunctionCall* statement) {
+  auto callee = functions.find(statement->getFunction());
+  if (callee == functions.end())
+    error("Couldn't find the function " + statement->getName() + " while generating IR");
+  llvm::Function* function = callee->second;
+
+  const vector<Expression*> arguments = statement->getArguments();
+  vector<llvm::Value*> values;
+  for (size_t index = 0; index < arguments.size(); index++) {
+    llvm::Type* type = function->getFunctionType()->getParamType(index);
+    values.push_back(generateConversion(getLLVMValue(arguments[index]->getASTNode(), type), arguments[index]->getType(), type));
+  }
+
+  return builder.CreateCall(function, values, function->getReturnType()->isVoidTy() ? "" : statement->getName() + "_call");
+}
 void Codegen::visit(const Identifier* statement) { statement->print(); }
-void Codegen::visit(const If* statement) { statement->print(); }
+// Every value gets its own case in the switch instruction and LLVM picks the lowering: a jump
+// table when they're dense enough, a binary search over them or a few compares otherwise
+void Codegen::visit(const Switch* statement) {
+  llvm::Function* function = builder.GetInsertBlock()->getParent();
+  const Case* fallback = statement->getDefault();
+  llvm::BasicBlock* endBlock = llvm::BasicBlock::Create(context, "switch.end", function);
+  llvm::BasicBlock* defaultBlock = fallback ? llvm::BasicBlock::Create(context, "switch.default", function) : endBlock;
+
+  llvm::Value* value = getLLVMValue(statement->getValue(), getLLVMType(statement->getValueType()));
+  llvm::SwitchInst* instruction = builder.CreateSwitch(value, defaultBlock);
+
+  vector<std::pair<const Case*, llvm::BasicBlock*>> arms;
+  for (const Case* current : statement->getCases()) {
+    if (current == fallback) {
+      arms.push_back({ current, defaultBlock });
+      continue;
+    }
+
+    llvm::BasicBlock* block = llvm::BasicBlock::Create(context, "switch.case", function);
+    for (const Constant& label : current->getLabels())
+      instruction->addCase(llvm::cast<llvm::ConstantInt>(generateConstant(label)), block);
+    arms.push_back({ current, block });
+  }
+
+  for (const auto& [current, block] : arms) {
+    builder.SetInsertPoint(block);
+    current->accept(this);
+    if (!builder.GetInsertBlock()->getTerminator())
+      builder.CreateBr(endBlock);
+  }
+
+  builder.SetInsertPoint(endBlock);
+}
+
+void Codegen::visit(const Case* statement) {
+  generateBody(statement->getBody());
+}
+
+// The else if chain is nested, every if has at most one else
+void Codegen::visit(const If* statement) {
+  llvm::Function* function = builder.GetInsertBlock()->getParent();
+  const vector<Else*> elses = statement->getElses();
+  llvm::BasicBlock* thenBlock = llvm::BasicBlock::Create(context, "if.then", function);
+  llvm::BasicBlock* elseBlock = elses.empty() ? nullptr : llvm::BasicBlock::Create(context, "if.else", function);
+  llvm::BasicBlock* endBlock = llvm::BasicBlock::Create(context, "if.end", function);
+
+  builder.CreateCondBr(getLLVMValue(statement->getCondition()), thenBlock, elseBlock ? elseBlock : endBlock, getBranchWeights(statement));
+
+  builder.SetInsertPoint(thenBlock);
+  generateBody(statement->getBody());
+  if (!builder.GetInsertBlock()->getTerminator())
+    builder.CreateBr(endBlock);
+
+  if (elseBlock) {
+    builder.SetInsertPoint(elseBlock);
+    elses.front()->accept(this);
+    if (!builder.GetInsertBlock()->getTerminator())
+      builder.CreateBr(endBlock);
+  }
+
+  builder.SetInsertPoint(endBlock);
+}
+void Codegen::visit(const IndexOperator* statement) { statement->print(); }
 void Codegen::visit(const ListInitializer* statement) { statement->print(); }
 void Codegen::visit(const Literal* statement) { statement->print(); }
-void Codegen::visit(const LoopControl* statement) { statement->print(); }
+
+void Codegen::visit(const LoopControl* statement) {
+  if (loops.empty())
+    error(statement->getKeyword() + " statement must be inside a loop");
+
+  if (statement->getKeyword() == "break")
+    builder.CreateBr(loops.back().breakBlock);
+  else
+    builder.CreateBr(loops.back().continueBlock);
+}
+
 void Codegen::visit(const Operator* statement) { statement->print(); }
 void Codegen::visit(const Parameter* statement) { statement->print(); }
 
+// return tail becomes a musttail call, which reuses the frame of the caller at every optimization
+// level. LLVM only guarantees it when both functions have the same signature
 void Codegen::visit(const Return* statement) { 
   const ASTNode* AST_Value = statement->getValue()->getASTNode();
+  llvm::Function* caller = builder.GetInsertBlock()->getParent();
+  llvm::Type* IR_ReturnType = caller->getReturnType();
+
+  if (statement->isTail() && !AST_Value->getConstant()) {
+    const FunctionCall* functionCall = dynamic_cast<const FunctionCall*>(AST_Value);
+    llvm::CallInst* call = generateCall(functionCall);
+    if (call->getFunctionType() != caller->getFunctionType())
+      error("Return tail calls " + functionCall->getName() + ", it must have the same parameter and return types as " + caller->getName().str());
 
-  llvm::Value* IR_Value = getLLVMValue(AST_Value);
-  builder.CreateRet(IR_Value);
+    call->setTailCallKind(llvm::CallInst::TCK_MustTail);
+    builder.CreateRet(call);
+    return;
+  }
+
+  llvm::Value* IR_Value = getLLVMValue(AST_Value, IR_ReturnType);
+  builder.CreateRet(generateConversion(IR_Value, statement->getValue()->getType(), IR_ReturnType));
 }
 
-void Codegen::visit(const Struct* statement) { statement->print(); }
+// Members are stored in declaration order unless the struct is #reorder, then they're sorted by
+// decreasing alignment, which leaves no padding between them. #align raises the alignment of
+// the variables and pads the size to a multiple of it, so the elements of arrays stay aligned
+void Codegen::visit(const Struct* statement) {
+  const llvm::DataLayout& layout = module->getDataLayout();
+  const vector<Variable*> members = statement->getMembers();
+  const bool isPacked = statement->findAnnotation("packed") != nullptr;
+
+  vector<llvm::Type*> declared;
+  for (const Variable* member : members)
+    declared.push_back(getLLVMType(member->getType()));
+
+  vector<size_t> order(members.size());
+  std::iota(order.begin(), order.end(), 0);
+  if (statement->findAnnotation("reorder"))
+    std::stable_sort(order.begin(), order.end(), [&](const size_t a, const size_t b) {
+      return layout.getABITypeAlign(declared[a]) > layout.getABITypeAlign(declared[b]);
+    });
+
+  vector<llvm::Type*> fields;
+  unordered_map<string, unsigned int> indices;
+  for (const size_t index : order) {
+    indices.emplace(members[index]->getIdentifier(), fields.size());
+    fields.push_back(declared[index]);
+  }
+
+  llvm::StructType* natural = llvm::StructType::get(context, fields, isPacked);
+  uint64_t alignment = layout.getABITypeAlign(natural).value();
+  if (const Annotation* align = statement->findAnnotation("align"))
+    alignment = std::max(alignment, align->getArgument().value());
+
+  const uint64_t size = layout.getTypeAllocSize(natural).getKnownMinValue();
+  if (size % alignment != 0)
+    fields.push_back(llvm::ArrayType::get(builder.getInt8Ty(), llvm::alignTo(size, alignment) - size));
+
+  llvm::StructType* type = llvm::StructType::create(context, fields, statement->getIdentifier(), isPacked);
+  scope.declareStruct(statement->getIdentifier(), { type, indices, alignment });
+
+  if (!isWorker) {
+    const uint64_t declaredSize = layout.getTypeAllocSize(llvm::StructType::get(context, declared, isPacked)).getKnownMinValue();
+    reportStructLayout(statement, type, alignment, llvm::alignTo(declaredSize, alignment));
+  }
+}
+
+// Printed while compiling, to keep an eye on how many cache lines the hot records take
+void Codegen::reportStructLayout(const Struct* statement, llvm::StructType* type, const uint64_t alignment, const uint64_t declaredSize) {
+  const llvm::DataLayout& layout = module->getDataLayout();
+  const uint64_t size = layout.getTypeAllocSize(type).getKnownMinValue();
+
+  uint64_t membersSize = 0;
+  for (const Variable* member : statement->getMembers())
+    membersSize += layout.getTypeAllocSize(getLLVMType(member->getType())).getKnownMinValue();
+
+  std::lock_guard<std::mutex> lock(getOutputMutex());
+  cout << "Struct " << statement->getIdentifier() << ": " << size << " bytes, aligned to " << alignment << ", " << size - membersSize << " bytes of padding";
+  if (declaredSize != size)
+    cout << " (" << declaredSize << " bytes in declaration order)";
+  cout << '\n';
+}
 void Codegen::visit(const Type* statement) { statement->print(); }
 void Codegen::visit(const UnaryOperator* statement) { statement->print(); }
 
 void Codegen::visit(const Variable* statement) { 
-  statement->print(); 
+  if (statement->isGlobal()) {
+    generateGlobalVariable(statement, true);
+    return;
+  }
+
+  llvm::Type* type = getLLVMType(statement->getType(), statement->getTypeToString());
+  if (!type)
+    error("Couldn't find the LLVM type " + statement->getTypeToString() + " of variable " + statement->getIdentifier());
+
+  optional<uint64_t> structAlignment = {};
+  if (llvm::StructType* structType = llvm::dyn_cast<llvm::StructType>(type))
+    structAlignment = scope.findStructAlignment(structType);
+
+  // Every member gets an array of its own, starting on a cache line of its own
+  if (statement->findAnnotation("soa")) {
+    llvm::StructType* structType = llvm::cast<llvm::StructType>(type);
+    for (const Variable* member : statement->getStructure()->getMembers()) {
+      const string name = statement->getIdentifier() + "." + member->getIdentifier();
+      llvm::Type* memberType = structType->getElementType(scope.findStructMemberIndex(structType, member->getIdentifier()).value());
+      llvm::AllocaInst* array = createEntryBlockAlloca(llvm::ArrayType::get(memberType, statement->getArraySize()), name);
+      array->setAlignment(std::max(array->getAlign(), llvm::Align(64)));
+      scope.declareVariable(name, array);
+    }
+    return;
+  }
+
+  if (statement->isArray()) {
+    llvm::ArrayType* arrayType = llvm::ArrayType::get(type, statement->getArraySize());
+
+    // A constant table is read-only data emitted once, it isn't rebuilt every time the function runs
+    if (statement->isConstant() && statement->getValue()->getNodeType() == ASTNodeType::LIST_INITIALIZER && statement->hasConstantInitializer()) {
+      llvm::GlobalVariable* table = new llvm::GlobalVariable(*module, arrayType, true, llvm::GlobalValue::PrivateLinkage, generateGlobalInitializer(statement, arrayType), statement->getIdentifier());
+      table->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+      table->setAlignment(module->getDataLayout().getPreferredAlign(table));
+      scope.declareVariable(statement->getIdentifier(), IRVariable{ table, arrayType });
+      return;
+    }
+
+    llvm::AllocaInst* array = createEntryBlockAlloca(arrayType, statement->getIdentifier());
+    if (structAlignment)
+      array->setAlignment(llvm::Align(structAlignment.value()));
+
+    // Elements missing from the list initializer are left uninitialized like any other local
+    if (const ListInitializer* list = dynamic_cast<const ListInitializer*>(statement->getValue())) {
+      const vector<Expression*> elements = list->getList();
+      for (size_t index = 0; index < elements.size(); index++) {
+        llvm::Value* element = generateConversion(getLLVMValue(elements[index]->getASTNode(), type), elements[index]->getType(), type);
+        builder.CreateStore(element, builder.CreateConstInBoundsGEP2_64(arrayType, array, 0, index));
+      }
+    }
+
+    scope.declareVariable(statement->getIdentifier(), array);
+    return;
+  }
+
+  llvm::AllocaInst* variable = createEntryBlockAlloca(type, statement->getIdentifier());
+
+  if (const Struct* structure = statement->getStructure()) {
+    variable->setAlignment(llvm::Align(structAlignment.value()));
+
+    // The list initializer has a value for every member in declaration order, without it
+    // only the members declared with a value in the struct are initialized
+    const ListInitializer* list = dynamic_cast<const ListInitializer*>(statement->getValue());
+    const vector<Variable*> members = structure->getMembers();
+    vector<llvm::Value*> values(members.size(), nullptr);
+    for (size_t index = 0; index < members.size(); index++) {
+      llvm::Type* memberType = getLLVMType(members[index]->getType());
+      if (list) {
+        const Expression* element = list->getList()[index];
+        values[index] = generateConversion(getLLVMValue(element->getASTNode(), memberType), element->getType(), memberType);
+      }
+      else if (members[index]->getValue()->getNodeType() != ASTNodeType::NOTHING)
+        values[index] = generateInitializer(members[index], memberType);
+    }
+
+    scope.declareVariable(statement->getIdentifier(), variable);
+    for (size_t index = 0; index < members.size(); index++) {
+      if (!values[index])
+        continue;
+      const Member member = generateMemberPointer(statement->getIdentifier(), members[index]->getIdentifier());
+      builder.CreateAlignedStore(values[index], member.address, member.alignment);
+    }
+    return;
+  }
+
+  if (statement->getValue()->getNodeType() != ASTNodeType::NOTHING)
+    builder.CreateStore(generateInitializer(statement, type), variable);
+
+  // Declared after the initializer, so `var int x = x;` still reads the outer x
+  scope.declareVariable(statement->getIdentifier(), IRVariable{ variable, variable->getAllocatedType(), getPointeeType(statement->getType()) });
+}
+
+// Globals live in the module data. Their initial value is known at compile time, so it's emitted
+// with them instead of code running before main. Const globals are read-only data: loads from
+// them fold and identical ones can be merged. Partitions generated in parallel only declare them
+void Codegen::generateGlobalVariable(const Variable* statement, const bool isDefinition) {
+  llvm::Type* type = getLLVMType(statement->getType(), statement->getTypeToString());
+  if (!type)
+    error("Couldn't find the LLVM type " + statement->getTypeToString() + " of variable " + statement->getIdentifier());
+
+  if (statement->findAnnotation("soa")) {
+    llvm::StructType* structType = llvm::cast<llvm::StructType>(type);
+    for (const Variable* member : statement->getStructure()->getMembers()) {
+      llvm::Type* memberType = structType->getElementType(scope.findStructMemberIndex(structType, member->getIdentifier()).value());
+      llvm::ArrayType* arrayType = llvm::ArrayType::get(memberType, statement->getArraySize());
+      createGlobalVariable(statement, statement->getIdentifier() + "." + member->getIdentifier(), arrayType, isDefinition ? llvm::Constant::getNullValue(arrayType) : nullptr, llvm::Align(64));
+    }
+    return;
+  }
+
+  llvm::MaybeAlign alignment;
+  if (llvm::StructType* structType = llvm::dyn_cast<llvm::StructType>(type))
+    alignment = llvm::Align(scope.findStructAlignment(structType).value());
+  if (statement->isArray())
+    type = llvm::ArrayType::get(type, statement->getArraySize());
+
+  createGlobalVariable(statement, statement->getIdentifier(), type, isDefinition ? generateGlobalInitializer(statement, type) : nullptr, alignment);
+}
+
+void Codegen::createGlobalVariable(const Variable* statement, const string& name, llvm::Type* type, llvm::Constant* initializer, const llvm::MaybeAlign alignment) {
+  llvm::GlobalVariable* global = new llvm::GlobalVariable(*module, type, statement->isConstant(), llvm::GlobalValue::ExternalLinkage, initializer, name);
+  global->setAlignment(std::max(module->getDataLayout().getPreferredAlign(global), alignment.valueOrOne()));
+  if (statement->isConstant())
+    global->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+
+  if (initializer && !statement->findAnnotation("export"))
+    internalGlobals.push_back(global);
+  scope.declareGlobalVariable(name, IRVariable{ global, type, getPointeeType(statement->getType()) });
 }
 
-void Codegen::visit(const While* statement) { statement->print(); }
+// Checked to be known at compile time by the semantic analysis, what isn't initialized is zero
+llvm::Constant* Codegen::generateGlobalInitializer(const Variable* statement, llvm::Type* type) {
+  const ASTNode* value = statement->getValue();
+  const ListInitializer* list = dynamic_cast<const ListInitializer*>(value);
+
+  if (llvm::ArrayType* arrayType = llvm::dyn_cast<llvm::ArrayType>(type)) {
+    vector<llvm::Constant*> elements(arrayType->getNumElements(), llvm::Constant::getNullValue(arrayType->getElementType()));
+    if (list)
+      for (size_t index = 0; index < list->getList().size(); index++)
+        elements[index] = generateConstant(list->getList()[index]->getASTNode(), statement->getType());
+    return llvm::ConstantArray::get(arrayType, elements);
+  }
+
+  if (const Struct* structure = statement->getStructure()) {
+    llvm::StructType* structType = llvm::cast<llvm::StructType>(type);
+    vector<llvm::Constant*> fields;
+    for (llvm::Type* field : structType->elements())
+      fields.push_back(llvm::Constant::getNullValue(field));
+
+    const vector<Variable*> members = structure->getMembers();
+    for (size_t index = 0; index < members.size(); index++) {
+      const ASTNode* member = list ? list->getList()[index]->getASTNode() : members[index]->getValue();
+      if (member->getNodeType() != ASTNodeType::NOTHING)
+        fields[scope.findStructMemberIndex(structType, members[index]->getIdentifier()).value()] = generateConstant(member, members[index]->getType());
+    }
+    return llvm::ConstantStruct::get(structType, fields);
+  }
+
+  if (list) {
+    vector<llvm::Constant*> lanes;
+    for (const Expression* element : list->getList())
+      lanes.push_back(generateConstant(element->getASTNode(), Type::GetElementType(statement->getType())));
+    return llvm::ConstantVector::get(lanes);
+  }
+
+  if (value->getNodeType() == ASTNodeType::NOTHING)
+    return llvm::Constant::getNullValue(type);
+  return generateConstant(value, statement->getType());
+}
+
+// Value known at compile time converted to the type it initializes, a scalar given to a vector is splat
+llvm::Constant* Codegen::generateConstant(const ASTNode* value, const ASTNodeType type) {
+  llvm::Constant* constant = generateConstant(*Constant::Convert(Constant::Of(value), Type::GetElementType(type)));
+  if (Type::IsVector(type))
+    return llvm::ConstantVector::getSplat(llvm::ElementCount::getFixed(Type::GetLaneCount(type)), constant);
+  return constant;
+}
+
+// Value of a scalar or vector variable declared with one, vectors can be initialized lane by lane
+llvm::Value* Codegen::generateInitializer(const Variable* variable, llvm::Type* type) {
+  const ListInitializer* list = dynamic_cast<const ListInitializer*>(variable->getValue());
+  if (!list)
+    return generateConversion(getLLVMValue(variable->getValue(), type), variable->getValueType(), type);
+
+  if (!type->isVectorTy())
+    error("Couldn't generate the list initializer of " + variable->getIdentifier());
+
+  // Every lane is inserted one after the other, constant lanes fold into a single vector constant
+  llvm::Value* lanes = llvm::PoisonValue::get(type);
+  const vector<Expression*> elements = list->getList();
+  for (size_t index = 0; index < elements.size(); index++) {
+    llvm::Value* element = generateConversion(getLLVMValue(elements[index]->getASTNode(), type), elements[index]->getType(), type->getScalarType());
+    lanes = builder.CreateInsertElement(lanes, element, builder.getInt64(index), "lane");
+  }
+  return lanes;
+}
+
+void Codegen::visit(const While* statement) {
+  llvm::Function* function = builder.GetInsertBlock()->getParent();
+  llvm::BasicBlock* preheaderBlock = llvm::BasicBlock::Create(context, "while.preheader", function);
+  llvm::BasicBlock* headerBlock = llvm::BasicBlock::Create(context, "while.cond", function);
+  llvm::BasicBlock* bodyBlock = llvm::BasicBlock::Create(context, "while.body", function);
+  llvm::BasicBlock* latchBlock = llvm::BasicBlock::Create(context, "while.latch", function);
+  llvm::BasicBlock* exitBlock = llvm::BasicBlock::Create(context, "while.end", function);
+
+  builder.CreateBr(preheaderBlock);
+  builder.SetInsertPoint(preheaderBlock);
+  builder.CreateBr(headerBlock);
+
+  builder.SetInsertPoint(headerBlock);
+  builder.CreateCondBr(getLLVMValue(statement->getCondition()), bodyBlock, exitBlock);
+
+  builder.SetInsertPoint(bodyBlock);
+  loops.push_back({ latchBlock, exitBlock });
+  generateBody(statement->getBody());
+  loops.pop_back();
+  if (!builder.GetInsertBlock()->getTerminator())
+    builder.CreateBr(latchBlock);
+
+  builder.SetInsertPoint(latchBlock);
+  builder.CreateBr(headerBlock)->setMetadata(llvm::LLVMContext::MD_loop, getLoopMetadata(statement));
+
+  builder.SetInsertPoint(exitBlock);
+}
+
+void Codegen::visit(const DoWhile* statement) {
+  llvm::Function* function = builder.GetInsertBlock()->getParent();
+  llvm::BasicBlock* preheaderBlock = llvm::BasicBlock::Create(context, "do.preheader", function);
+  llvm::BasicBlock* headerBlock = llvm::BasicBlock::Create(context, "do.body", function);
+  llvm::BasicBlock* latchBlock = llvm::BasicBlock::Create(context, "do.cond", function);
+  llvm::BasicBlock* exitBlock = llvm::BasicBlock::Create(context, "do.end", function);
+
+  builder.CreateBr(preheaderBlock);
+  builder.SetInsertPoint(preheaderBlock);
+  builder.CreateBr(headerBlock);
+
+  builder.SetInsertPoint(headerBlock);
+  loops.push_back({ latchBlock, exitBlock });
+  generateBody(statement->getBody());
+  loops.pop_back();
+  if (!builder.GetInsertBlock()->getTerminator())
+    builder.CreateBr(latchBlock);
+
+  builder.SetInsertPoint(latchBlock);
+  builder.CreateCondBr(getLLVMValue(statement->getCondition()), headerBlock, exitBlock)
+    ->setMetadata(llvm::LLVMContext::MD_loop, getLoopMetadata(statement));
+
+  builder.SetInsertPoint(exitBlock);
+}
+
+void Codegen::visit(const For* statement) {
+  if (statement->isParallel())
+    return generateParallelFor(statement);
+
+  llvm::Function* function = builder.GetInsertBlock()->getParent();
+  llvm::BasicBlock* preheaderBlock = llvm::BasicBlock::Create(context, "for.preheader", function);
+  llvm::BasicBlock* headerBlock = llvm::BasicBlock::Create(context, "for.cond", function);
+  llvm::BasicBlock* bodyBlock = llvm::BasicBlock::Create(context, "for.body", function);
+  llvm::BasicBlock* latchBlock = llvm::BasicBlock::Create(context, "for.inc", function);
+  llvm::BasicBlock* exitBlock = llvm::BasicBlock::Create(context, "for.end", function);
+
+  // The induction variable is only visible inside the loop
+  scope.enterScope();
+  builder.CreateBr(preheaderBlock);
+  builder.SetInsertPoint(preheaderBlock);
+  statement->getInitialization()->accept(this);
+  builder.CreateBr(headerBlock);
+
+  builder.SetInsertPoint(headerBlock);
+  builder.CreateCondBr(getLLVMValue(statement->getCondition()->getASTNode()), bodyBlock, exitBlock);
+
+  builder.SetInsertPoint(bodyBlock);
+  loops.push_back({ latchBlock, exitBlock });
+  generateBody(statement->getBody());
+  loops.pop_back();
+  if (!builder.GetInsertBlock()->getTerminator())
+    builder.CreateBr(latchBlock);
+
+  builder.SetInsertPoint(latchBlock);
+  statement->getUpdate()->accept(this);
+  builder.CreateBr(headerBlock)->setMetadata(llvm::LLVMContext::MD_loop, getLoopMetadata(statement));
+  scope.exitScope();
+
+  builder.SetInsertPoint(exitBlock);
+}
+
+// The body is outlined to `void body(i8** context, i64 begin, i64 end)` running the iterations
+// [begin, end) of the loop, and the runtime calls it on chunks of iterations from its workers.
+// Variables declared in the body are private to every iteration, the ones of the enclosing
+// function are shared and reached through the context, captured the first time they're used
+void Codegen::generateParallelFor(const For* statement) {
+  const Variable* induction = statement->getInitialization();
+  const BinaryOperator* condition = dynamic_cast<const BinaryOperator*>(statement->getCondition()->getASTNode());
+  const AssignmentOperator* update = statement->getUpdate();
+  llvm::Type* inductionType = getLLVMType(induction->getType());
+  llvm::Type* int64 = builder.getInt64Ty();
+  llvm::Type* pointer = llvm::PointerType::get(builder.getInt8Ty(), 0);
+
+  // The start, the bound and the step are evaluated once, before any iteration runs
+  auto evaluate = [&](const ASTNode* value, const ASTNodeType type) {
+    llvm::Value* converted = generateConversion(getLLVMValue(value, inductionType), type, inductionType);
+    return generateConversion(converted, induction->getType(), int64);
+  };
+  llvm::Value* start = evaluate(induction->getValue(), induction->getValueType());
+  llvm::Value* bound = evaluate(condition->getRight(), condition->getRightType());
+  llvm::Value* step = evaluate(update->getExpression(), update->getExpressionType());
+
+  llvm::Value* distance = builder.CreateSub(bound, start, "parallel.distance");
+  if (condition->getOperator() == TokenType::LESS_EQUAL)
+    distance = builder.CreateAdd(distance, builder.getInt64(1), "parallel.distance");
+  llvm::Value* isPositiveStep = builder.CreateICmpSGT(step, builder.getInt64(0));
+  llvm::Value* safeStep = builder.CreateSelect(isPositiveStep, step, builder.getInt64(1));
+  llvm::Value* iterations = builder.CreateSDiv(builder.CreateAdd(distance, builder.CreateSub(safeStep, builder.getInt64(1))), safeStep);
+  llvm::Value* hasIterations = builder.CreateAnd(isPositiveStep, builder.CreateICmpSGT(distance, builder.getInt64(0)));
+  iterations = builder.CreateSelect(hasIterations, iterations, builder.getInt64(0), "parallel.iterations");
+
+  llvm::AllocaInst* startAddress = createEntryBlockAlloca(int64, "parallel.start");
+  llvm::AllocaInst* stepAddress = createEntryBlockAlloca(int64, "parallel.step");
+  builder.CreateStore(start, startAddress);
+  builder.CreateStore(safeStep, stepAddress);
+
+  llvm::FunctionType* bodyType = llvm::FunctionType::get(builder.getVoidTy(), { llvm::PointerType::get(pointer, 0), int64, int64 }, false);
+  llvm::Function* parent = builder.GetInsertBlock()->getParent();
+  llvm::Function* body = llvm::Function::Create(bodyType, llvm::Function::InternalLinkage, parent->getName() + ".parallel", module.get());
+  body->addFnAttr(llvm::Attribute::NoUnwind);
+  llvm::Argument* contextArgument = body->getArg(0);
+  llvm::Argument* begin = body->getArg(1);
+  llvm::Argument* end = body->getArg(2);
+  contextArgument->setName("context");
+  begin->setName("begin");
+  end->setName("end");
+
+  const llvm::IRBuilderBase::InsertPoint insertPoint = builder.saveIP();
+  vector<Loop> enclosingLoops = std::move(loops);
+  loops.clear();
+  llvm::BasicBlock* entryBlock = llvm::BasicBlock::Create(context, "entry", body);
+  llvm::BasicBlock* headerBlock = llvm::BasicBlock::Create(context, "parallel.cond", body);
+  llvm::BasicBlock* bodyBlock = llvm::BasicBlock::Create(context, "parallel.body", body);
+  llvm::BasicBlock* latchBlock = llvm::BasicBlock::Create(context, "parallel.inc", body);
+  llvm::BasicBlock* exitBlock = llvm::BasicBlock::Create(context, "parallel.end", body);
+
+  outlined.push_back({ body, contextArgument, {}, {} });
+  const IRVariable startVariable = captureVariable({ startAddress, int64 }, outlined.size());
+  const IRVariable stepVariable = captureVariable({ stepAddress, int64 }, outlined.size());
+
+  builder.SetInsertPoint(entryBlock);
+  llvm::AllocaInst* index = createEntryBlockAlloca(int64, "parallel.index");
+  builder.CreateStore(begin, index);
+  llvm::Value* firstValue = builder.CreateLoad(int64, startVariable.address, "start");
+  llvm::Value* stride = builder.CreateLoad(int64, stepVariable.address, "step");
+  builder.CreateBr(headerBlock);
+
+  builder.SetInsertPoint(headerBlock);
+  llvm::Value* current = builder.CreateLoad(int64, index, "parallel.index");
+  builder.CreateCondBr(builder.CreateICmpSLT(current, end), bodyBlock, exitBlock);
+
+  scope.enterScope();
+  builder.SetInsertPoint(bodyBlock);
+  llvm::Value* value = builder.CreateAdd(firstValue, builder.CreateMul(current, stride), induction->getIdentifier());
+  llvm::AllocaInst* inductionAddress = createEntryBlockAlloca(inductionType, induction->getIdentifier());
+  builder.CreateStore(builder.CreateTrunc(value, inductionType), inductionAddress);
+  scope.declareVariable(induction->getIdentifier(), inductionAddress);
+
+  loops.push_back({ latchBlock, exitBlock });
+  generateBody(statement->getBody());
+  loops.pop_back();
+  if (!builder.GetInsertBlock()->getTerminator())
+    builder.CreateBr(latchBlock);
+  scope.exitScope();
+
+  builder.SetInsertPoint(latchBlock);
+  builder.CreateStore(builder.CreateAdd(builder.CreateLoad(int64, index), builder.getInt64(1)), index);
+  builder.CreateBr(headerBlock)->setMetadata(llvm::LLVMContext::MD_loop, getLoopMetadata(statement));
+
+  builder.SetInsertPoint(exitBlock);
+  builder.CreateRetVoid();
+  llvm::verifyFunction(*body);
+
+  // Every capture is known now, the context is filled in the enclosing function
+  const vector<llvm::Value*> captures = std::move(outlined.back().captures);
+  outlined.pop_back();
+  loops = std::move(enclosingLoops);
+  builder.restoreIP(insertPoint);
+
+  llvm::ArrayType* contextType = llvm::ArrayType::get(pointer, captures.size());
+  llvm::AllocaInst* contextArray = createEntryBlockAlloca(contextType, "parallel.context");
+  for (size_t slot = 0; slot < captures.size(); slot++)
+    builder.CreateStore(builder.CreateBitCast(captures[slot], pointer), builder.CreateConstInBoundsGEP2_64(contextType, contextArray, 0, slot));
+
+  const Annotation* chunk = statement->findAnnotation("chunk");
+  llvm::FunctionType* runtimeType = llvm::FunctionType::get(builder.getVoidTy(), { llvm::PointerType::get(bodyType, 0), pointer, int64, int64 }, false);
+  llvm::FunctionCallee runtime = module->getOrInsertFunction(SHQ_PARALLEL_FOR, runtimeType);
+  builder.CreateCall(runtime, { body, builder.CreateBitCast(contextArray, pointer), iterations, builder.getInt64(chunk ? chunk->getArgument().value() : 0) });
+}
+
+// Variables of the enclosing functions are looked up as usual, the ones that don't belong
+// to the function being generated are replaced by the pointer captured in its context
+// Locals shadow the globals, which are reached directly from outlined bodies too
+optional<IRVariable> Codegen::findVariable(const string& name) {
+  optional<IRVariable> variable = scope.findVariable(name);
+  if (!variable)
+    return scope.findGlobalVariable(name);
+  if (outlined.empty())
+    return variable;
+  return captureVariable(variable.value(), outlined.size());
+}
+
+// depth is the number of outlined bodies the variable is seen through, 0 being the outermost function
+IRVariable Codegen::captureVariable(const IRVariable& variable, const size_t depth) {
+  if (depth == 0)
+    return variable;
+
+  // Constant tables of the enclosing function are globals, they're reached directly
+  if (llvm::isa<llvm::GlobalVariable>(variable.address))
+    return variable;
+
+  OutlinedBody& body = outlined[depth - 1];
+  const llvm::Instruction* instruction = llvm::dyn_cast<llvm::Instruction>(variable.address);
+  if (instruction && instruction->getFunction() == body.function)
+    return variable;
+
+  // A nested body captures from the body around it, which may have to capture it in turn
+  const IRVariable enclosing = captureVariable(variable, depth - 1);
+  auto captured = body.pointers.find(enclosing.address);
+  if (captured != body.pointers.end())
+    return { captured->second, variable.type, variable.pointee };
+
+  llvm::BasicBlock& entry = body.function->getEntryBlock();
+  llvm::IRBuilder<> entryBuilder(&entry, entry.begin());
+
+  llvm::Type* pointer = llvm::PointerType::get(builder.getInt8Ty(), 0);
+  llvm::Value* slot = entryBuilder.CreateConstInBoundsGEP1_64(pointer, body.context, body.captures.size());
+  llvm::Value* address = entryBuilder.CreateBitCast(entryBuilder.CreateLoad(pointer, slot), enclosing.address->getType(), "captured");
+
+  body.captures.push_back(enclosing.address);
+  body.pointers.emplace(enclosing.address, address);
+  return { address, variable.type, variable.pointee };
+}
@@ -10,9 +10,12 @@
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/Scalar.h"
+#include "llvm/Passes/OptimizationLevel.h"
 
 #include "../includes/ast.h"
+#include "../includes/options.hpp"
 #include "irscope.h"
+#include "emitter.h"
 
 using std::string;
 using std::unique_ptr;
@@ -21,10 +24,12 @@ class Codegen {
 public:
 
   //Constructor
-  Codegen(const vector<unique_ptr<ASTNode>>& ast); 
+  Codegen(const vector<unique_ptr<ASTNode>>& ast, const Options& options); 
 
   void generateIR();
+  void optimize();
   void executeIR();
+  static void executeModule(unique_ptr<llvm::Module> module, const Options& options);
 
   //Getter & Setter
   llvm::LLVMContext& getContext();
@@ -32,18 +37,44 @@ public:
   llvm::IRBuilder<>& getBuilder();
 
   llvm::Type* getLLVMType(const ASTNodeType type, const string& str_type);
-  llvm::Value* getLLVMValue(const ASTNode* value);
+  llvm::Type* getPointeeType(const ASTNodeType type);
+  llvm::Value* getLLVMValue(const ASTNode* value, llvm::Type* expected = nullptr);
+  llvm::Constant* generateConstant(const Constant& constant);
+  llvm::Constant* generateConstant(const ASTNode* value, const ASTNodeType type);
 
   vector<llvm::Type*> getParametersType(const vector<Parameter*>& parameters);
+  llvm::Function* declareFunction(const Function* statement);
+  void internalizeSymbols();
+  llvm::MDNode* getLoopMetadata(const Annotated* loop);
+  llvm::MDNode* getBranchWeights(const Annotated* statement);
+  llvm::Value* generateElementPointer(const string& name, const ASTNode* index, const ASTNodeType indexType, llvm::Type*& elementType);
+  void generateBoundsCheck(llvm::Value* index, const uint64_t size);
+  llvm::AllocaInst* createEntryBlockAlloca(llvm::Type* type, const string& name);
+  llvm::Value* generateInitializer(const Variable* variable, llvm::Type* type);
+  void generateGlobalVariable(const Variable* statement, const bool isDefinition);
+  void createGlobalVariable(const Variable* statement, const string& name, llvm::Type* type, llvm::Constant* initializer, const llvm::MaybeAlign alignment);
+  llvm::Constant* generateGlobalInitializer(const Variable* statement, llvm::Type* type);
+  void generateAssignment(const AssignmentOperator* statement, llvm::Value* address, llvm::Type* type, const ASTNodeType targetType, const llvm::MaybeAlign alignment = {});
+  void generateBody(const vector<ASTNode*>& body);
+  void generateParallelFor(const For* statement);
+  optional<IRVariable> findVariable(const string& name);
   
   llvm::Value* generateBinaryOperator(const BinaryOperator* statement);
+  llvm::Value* generateLogicalOperator(const BinaryOperator* statement);
+  llvm::Value* generateOperation(const TokenType op, llvm::Value* left, llvm::Value* right, const bool isUnsigned);
   llvm::Value* generateUnaryOperator(const UnaryOperator* statement);
+  llvm::Value* generateAddress(const ASTNode* value);
   llvm::Value* generateCast(const Cast* statement);
+  llvm::Value* generateBuiltin(const FunctionCall* statement);
+  llvm::CallInst* generateCall(const FunctionCall* statement);
+  llvm::Value* generateConversion(llvm::Value* value, const ASTNodeType from, llvm::Type* to, const bool isTargetUnsigned = false);
 
   //Code Generation Methods
+  void visit(const Annotation* statement);
   void visit(const AssignmentOperator* statement);
   void visit(const BinaryOperator* statement);
   void visit(const Body* statement);
+  void visit(const Case* statement);
   void visit(const Cast* statement);
   void visit(const DotOperator* statement);
   void visit(const DoWhile* statement);
@@ -54,6 +85,7 @@ public:
   void visit(const FunctionCall* statement);
   void visit(const Identifier* statement);
   void visit(const If* statement);
+  void visit(const IndexOperator* statement);
   void visit(const ListInitializer* statement);
   void visit(const Literal* statement);
   void visit(const LoopControl* statement);
@@ -61,6 +93,7 @@ public:
   void visit(const Parameter* statement);
   void visit(const Return* statement);
   void visit(const Struct* statement);
+  void visit(const Switch* statement);
   void visit(const Type* statement);
   void visit(const UnaryOperator* statement);
   void visit(const Variable* statement);
@@ -68,10 +101,54 @@ public:
   
 
 private:
-  const vector<unique_ptr<ASTNode>>& ast;
+  // Worker used by generateParallelIR(), it only emits its share of the top-level nodes
+  // while the other functions are just declared so calls to them can be resolved at link time
+  Codegen(const vector<const ASTNode*>& nodes, const vector<const Function*>& prototypes, const vector<const Variable*>& globals, const Options& options);
+
+  // Targets of break/continue for the innermost loop being generated
+  struct Loop {
+    llvm::BasicBlock* continueBlock;
+    llvm::BasicBlock* breakBlock;
+  };
+
+  // Function a parallel for body is outlined to, it reaches the variables of the enclosing
+  // function through an array of pointers filled right before calling the runtime
+  struct OutlinedBody {
+    llvm::Function* function;
+    llvm::Value* context;
+    vector<llvm::Value*> captures; // addresses in the enclosing function, one per context slot
+    unordered_map<llvm::Value*, llvm::Value*> pointers; // enclosing address -> pointer in function
+  };
+
+  // Address of a struct member, with the alignment it's guaranteed to have at its offset
+  struct Member {
+    llvm::Value* address;
+    llvm::Type* type;
+    llvm::Align alignment;
+  };
+
+  Member generateMemberPointer(const DotOperator* statement);
+  Member generateMemberPointer(const string& name, const string& member);
+  Member generateMemberPointer(llvm::Value* address, llvm::StructType* structType, const string& name, const string& member);
+  void reportStructLayout(const Struct* statement, llvm::StructType* type, const uint64_t alignment, const uint64_t declaredSize);
+  IRVariable captureVariable(const IRVariable& variable, const size_t depth);
+  void generateTopLevel(const bool isFunction);
+  void generateParallelIR();
+  void optimizeFunctions();
+  void setTarget();
+  llvm::OptimizationLevel getOptimizationLevel() const;
+
+  vector<const ASTNode*> ast;
+  const Options& options;
   llvm::LLVMContext context;
   unique_ptr<llvm::Module> module;
   llvm::IRBuilder<> builder;
   IRScope scope;
-  
+  unordered_map<const Function*, llvm::Function*> functions; // declared up front, calls are resolved through it
+  vector<llvm::GlobalVariable*> internalGlobals; // defined here and not #export
+  unique_ptr<llvm::TargetMachine> targetMachine;
+  vector<Loop> loops;
+  vector<OutlinedBody> outlined;
+  const bool isWorker; // generates a partition of the module for generateParallelIR()
+
 };
\ No newline at end of file
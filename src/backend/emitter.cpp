@@ -0,0 +1,263 @@
+#include "emitter.h"
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/MC/TargetRegistry.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Program.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetOptions.h"
+#include "llvm/Transforms/Utils/SplitModule.h"
+
+#if LLVM_VERSION_MAJOR >= 17
+#include "llvm/TargetParser/Host.h"
+#else
+#include "llvm/Support/Host.h"
+#endif
+
+#include "../runtime/parallel.h"
+
+static constexpr const char* RUNTIME_LIBRARY = "libshqruntime.a";
+static constexpr const char* PROFILE_RUNTIME_HOOK = "__llvm_profile_runtime";
+
+ObjectEmitter::ObjectEmitter(const Options& options): m_options(options) {}
+
+void ObjectEmitter::emit(llvm::Module& module) const {
+  auto start = std::chrono::high_resolution_clock::now();
+
+  const string& path = m_options.getOutputPath();
+  const bool needsRuntime = module.getFunction(SHQ_PARALLEL_FOR) != nullptr;
+  const bool needsProfileRuntime = !m_options.getProfileGeneratePath().empty();
+  const string modulePath = needsRuntime || needsProfileRuntime ? path + ".module.o" : path;
+
+  const unsigned threads = m_options.getCodegenThreads();
+  if (threads > 1)
+    emitParallel(module, threads, modulePath);
+  else
+    emitPartition(module, modulePath);
+
+  vector<string> objects = { modulePath };
+  vector<string> undefined;
+  if (needsRuntime) {
+    const string runtime = findRuntime();
+    if (runtime.empty())
+      warning(string("Couldn't find ") + RUNTIME_LIBRARY + ", link the program with it to resolve " + SHQ_PARALLEL_FOR);
+    else
+      objects.push_back(runtime);
+  }
+
+  // Nothing in the instrumented code calls the profile runtime, it's pulled in by its hook symbol
+  if (needsProfileRuntime) {
+    const string runtime = findProfileRuntime();
+    if (runtime.empty())
+      warning("Couldn't find the profile runtime of compiler-rt, link the program with clang -fprofile-generate to write " + m_options.getProfileGeneratePath());
+    else {
+      objects.push_back(runtime);
+      undefined.push_back(PROFILE_RUNTIME_HOOK);
+    }
+  }
+
+  if (objects.size() > 1 && combine(objects, path, undefined))
+    llvm::sys::fs::remove(modulePath);
+  else if (modulePath != path) {
+    if (objects.size() > 1)
+      warning("Couldn't find 'ld' to merge the runtimes into the object, link the program with them");
+    llvm::sys::fs::rename(modulePath, path);
+  }
+
+  auto end = std::chrono::high_resolution_clock::now();
+  double seconds = std::chrono::duration<double>(end - start).count();
+  cout << "Emitting object took: " << seconds << " seconds\n";
+}
+
+void ObjectEmitter::initializeTarget() {
+  static std::once_flag initialized;
+  std::call_once(initialized, [](){
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+    llvm::InitializeNativeTargetAsmParser();
+  });
+}
+
+string ObjectEmitter::getHostCPU() {
+  return llvm::sys::getHostCPUName().str();
+}
+
+// The CPU name alone may imply features that are disabled on this machine (e.g. by a hypervisor)
+string ObjectEmitter::getHostFeatures() {
+#if LLVM_VERSION_MAJOR >= 19
+  const llvm::StringMap<bool> hostFeatures = llvm::sys::getHostCPUFeatures();
+#else
+  llvm::StringMap<bool> hostFeatures;
+  llvm::sys::getHostCPUFeatures(hostFeatures);
+#endif
+
+  string features;
+  for (const auto& feature: hostFeatures) {
+    if (!features.empty())
+      features += ',';
+    features += (feature.second ? "+" : "-") + feature.first().str();
+  }
+  return features;
+}
+
+unique_ptr<llvm::TargetMachine> ObjectEmitter::createTargetMachine(const unsigned optimizationLevel) {
+  initializeTarget();
+
+  const string triple = llvm::sys::getDefaultTargetTriple();
+  string message;
+  const llvm::Target* target = llvm::TargetRegistry::lookupTarget(triple, message);
+  if (!target)
+    error("Couldn't find the host target: " + message);
+
+  llvm::TargetOptions targetOptions;
+  unique_ptr<llvm::TargetMachine> machine(target->createTargetMachine(triple, getHostCPU(), getHostFeatures(), targetOptions, llvm::Reloc::PIC_));
+  if (!machine)
+    error("Couldn't create the target machine for " + triple);
+
+#if LLVM_VERSION_MAJOR >= 18
+  machine->setOptLevel(optimizationLevel == 0 ? llvm::CodeGenOptLevel::None :
+                       optimizationLevel < 3 ? llvm::CodeGenOptLevel::Default : llvm::CodeGenOptLevel::Aggressive);
+#else
+  machine->setOptLevel(optimizationLevel == 0 ? llvm::CodeGenOpt::None :
+                       optimizationLevel < 3 ? llvm::CodeGenOpt::Default : llvm::CodeGenOpt::Aggressive);
+#endif
+  return machine;
+}
+
+void ObjectEmitter::emitPartition(llvm::Module& module, const string& path) const {
+  unique_ptr<llvm::TargetMachine> machine = createTargetMachine(m_options.getOptimizationLevel());
+  module.setTargetTriple(machine->getTargetTriple().str());
+  module.setDataLayout(machine->createDataLayout());
+
+  std::error_code ec;
+  llvm::raw_fd_ostream output(path, ec, llvm::sys::fs::OF_None);
+  if (ec)
+    error("Couldn't open the output file " + path + ": " + ec.message());
+
+#if LLVM_VERSION_MAJOR >= 18
+  const llvm::CodeGenFileType fileType = llvm::CodeGenFileType::ObjectFile;
+#else
+  const llvm::CodeGenFileType fileType = llvm::CGFT_ObjectFile;
+#endif
+
+  llvm::legacy::PassManager passes;
+  if (machine->addPassesToEmitFile(passes, output, nullptr, fileType))
+    error("The host target can't emit object files");
+  passes.run(module);
+}
+
+void ObjectEmitter::emitParallel(llvm::Module& module, const unsigned threads, const string& path) const {
+  // The partitions still live in the module context, so they are serialized here
+  // and every thread reads its own copy back into a private context
+  vector<llvm::SmallVector<char, 0>> bitcodes;
+  llvm::SplitModule(module, threads, [&bitcodes](unique_ptr<llvm::Module> partition){
+    bitcodes.emplace_back();
+    llvm::raw_svector_ostream output(bitcodes.back());
+    llvm::WriteBitcodeToFile(*partition, output);
+  });
+
+  vector<string> paths;
+  vector<std::thread> workers;
+  for (size_t index = 0; index < bitcodes.size(); index++) {
+    paths.push_back(path + "." + std::to_string(index) + ".o");
+
+    workers.emplace_back([this, &bitcodes, &paths, index](){
+      llvm::LLVMContext context;
+      llvm::MemoryBufferRef buffer(llvm::StringRef(bitcodes[index].data(), bitcodes[index].size()), "partition");
+      llvm::Expected<unique_ptr<llvm::Module>> partition = llvm::parseBitcodeFile(buffer, context);
+      if (!partition)
+        error("Couldn't read back a module partition: " + llvm::toString(partition.takeError()));
+
+      emitPartition(**partition, paths[index]);
+    });
+  }
+  for (std::thread& worker: workers)
+    worker.join();
+
+  if (!combine(paths, path)) {
+    warning("Couldn't find 'ld' to combine the partitions, they were left in " + path + ".<n>.o");
+    return;
+  }
+
+  for (const string& partition: paths)
+    llvm::sys::fs::remove(partition);
+}
+
+// Archives among the objects only contribute the members that resolve undefined symbols,
+// the ones given in undefined included
+bool ObjectEmitter::combine(const vector<string>& objects, const string& path, const vector<string>& undefined) const {
+  llvm::ErrorOr<string> linker = llvm::sys::findProgramByName("ld");
+  if (!linker)
+    return false;
+
+  vector<llvm::StringRef> arguments = { *linker, "-r", "-o", path };
+  for (const string& symbol: undefined) {
+    arguments.push_back("-u");
+    arguments.push_back(symbol);
+  }
+  for (const string& object: objects)
+    arguments.push_back(object);
+
+  if (llvm::sys::ExecuteAndWait(*linker, arguments) != 0)
+    error("Couldn't combine the objects into " + path);
+  return true;
+}
+
+// The runtime is built next to the compiler and installed in ../lib relative to it
+string ObjectEmitter::findRuntime() {
+  static int anchor;
+  const string executable = llvm::sys::fs::getMainExecutable(nullptr, &anchor);
+  const string directory = llvm::sys::path::parent_path(executable).str();
+
+  for (const string& candidate: { directory + "/" + RUNTIME_LIBRARY, directory + "/../lib/" + RUNTIME_LIBRARY })
+    if (llvm::sys::fs::exists(candidate))
+      return candidate;
+  return "";
+}
+
+// The profile runtime is the one clang links with -fprofile-generate, depending on how
+// compiler-rt was built it's named after the architecture or kept in a per target directory
+string ObjectEmitter::findProfileRuntime() {
+  llvm::ErrorOr<string> clang = llvm::sys::findProgramByName("clang");
+  if (!clang)
+    return "";
+
+  llvm::SmallString<128> output;
+  if (llvm::sys::fs::createTemporaryFile("shqprofile", "txt", output))
+    return "";
+
+  const string architecture = llvm::Triple(llvm::sys::getDefaultTargetTriple()).getArchName().str();
+  string runtime;
+  for (const string& name: { string("libclang_rt.profile.a"), "libclang_rt.profile-" + architecture + ".a" }) {
+    const string argument = "--print-file-name=" + name;
+#if LLVM_VERSION_MAJOR >= 16
+    const std::optional<llvm::StringRef> redirects[] = { std::nullopt, llvm::StringRef(output), std::nullopt };
+    if (llvm::sys::ExecuteAndWait(*clang, { *clang, argument }, std::nullopt, redirects) != 0)
+#else
+    const llvm::Optional<llvm::StringRef> redirects[] = { llvm::None, llvm::StringRef(output), llvm::None };
+    if (llvm::sys::ExecuteAndWait(*clang, { *clang, argument }, llvm::None, redirects) != 0)
+#endif
+      continue;
+
+    // clang prints the name back unchanged when it doesn't find the file
+    llvm::ErrorOr<unique_ptr<llvm::MemoryBuffer>> printed = llvm::MemoryBuffer::getFile(output);
+    const string candidate = printed ? (*printed)->getBuffer().trim().str() : "";
+    if (llvm::sys::path::is_absolute(candidate) && llvm::sys::fs::exists(candidate)) {
+      runtime = candidate;
+      break;
+    }
+  }
+
+  llvm::sys::fs::remove(output);
+  return runtime;
+}
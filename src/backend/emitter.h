@@ -0,0 +1,46 @@
+#pragma once
+
+// C++ Headers
+#include <string>
+#include <vector>
+#include <memory>
+
+// LLVM Headers
+#include "llvm/IR/Module.h"
+#include "llvm/Target/TargetMachine.h"
+
+// Compiler Headers
+#include "../includes/error.hpp"
+#include "../includes/options.hpp"
+
+// Using declarations
+using std::string, std::vector, std::unique_ptr;
+
+// Lowers an optimized module to a native object file. With more than one codegen
+// thread the module is split with llvm::SplitModule, every partition is emitted
+// concurrently in its own context and the objects are combined with a relocatable link.
+// Modules calling into the runtime get it merged into the object the same way, and so do
+// the ones instrumented with --profile-generate with the profile runtime of compiler-rt.
+class ObjectEmitter {
+public:
+
+  // Constructor
+  ObjectEmitter(const Options& options);
+
+  void emit(llvm::Module& module) const;
+
+  // Host target shared by the optimizer, the JIT and the object emission
+  static void initializeTarget();
+  static string getHostCPU();
+  static string getHostFeatures();
+  static unique_ptr<llvm::TargetMachine> createTargetMachine(const unsigned optimizationLevel);
+
+private:
+  const Options& m_options;
+
+  void emitPartition(llvm::Module& module, const string& path) const;
+  void emitParallel(llvm::Module& module, const unsigned threads, const string& path) const;
+  bool combine(const vector<string>& objects, const string& path, const vector<string>& undefined = {}) const;
+  static string findRuntime();
+  static string findProfileRuntime();
+};
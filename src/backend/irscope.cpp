@@ -5,16 +5,12 @@ IRScope::~IRScope() { exitScope(); }
 
 void IRScope::enterScope() {
   localVariableMaps.emplace_back();
-  FunctionMaps.emplace_back();
   StructMaps.emplace_back();
 }
 
 void IRScope::exitScope() {
   if (!localVariableMaps.empty()) 
     localVariableMaps.pop_back();
-
-  if (!FunctionMaps.empty()) 
-    FunctionMaps.pop_back();
   
   if (!StructMaps.empty()) 
     StructMaps.pop_back();
@@ -24,6 +20,10 @@ void IRScope::declareVariable(const string& name, IRVariable variable) {
   localVariableMaps.back().emplace(name, variable);
 }
 
+void IRScope::declareVariable(const string& name, llvm::AllocaInst* variable) {
+  declareVariable(name, IRVariable{ variable, variable->getAllocatedType() });
+}
+
 optional<IRVariable> IRScope::findVariable(const string& name) const {
   for (int i = localVariableMaps.size() - 1; i >= 0; i--) {
     auto it = localVariableMaps[i].find(name);
@@ -33,31 +33,18 @@ optional<IRVariable> IRScope::findVariable(const string& name) const {
   return std::nullopt;
 }
 
-void IRScope::declareGlobalVariable(const string& name, IRGlobalVariable globalVariable) {
+void IRScope::declareGlobalVariable(const string& name, IRVariable globalVariable) {
   globalVariableMaps.emplace(name, globalVariable);
 }
 
-optional<IRGlobalVariable> IRScope::findGlobalVariable(const string& name) const {
+optional<IRVariable> IRScope::findGlobalVariable(const string& name) const {
   auto it = globalVariableMaps.find(name);
   if (it != globalVariableMaps.end()) 
     return it->second;
   return std::nullopt;
 }
 
-void IRScope::declareFunction(const string& name, IRFunction function) {
-  FunctionMaps.back().emplace(name, function);
-}
-
-optional<IRFunction> IRScope::findFunction(const string& name) const {
-  for (int i = FunctionMaps.size() - 1; i >= 0; i--) {
-    auto it = FunctionMaps[i].find(name);
-    if (it != FunctionMaps[i].end()) 
-      return it->second;
-  }
-  return std::nullopt;
-}
-
-void IRScope::declareStruct(const string& name, std::pair<IRStruct, unordered_map<string, unsigned int>> structInfos) {
+void IRScope::declareStruct(const string& name, IRStructInfo structInfos) {
   StructMaps.back().emplace(name, std::move(structInfos));
 }
 
@@ -65,7 +52,7 @@ optional<IRStruct> IRScope::findStruct(const string& name) const {
   for (int i = StructMaps.size() - 1; i >= 0; i--) {
     auto it = StructMaps[i].find(name);
     if (it != StructMaps[i].end()) 
-      return it->second.first;
+      return it->second.type;
   }
   return std::nullopt;
 }
@@ -74,13 +61,21 @@ optional<unsigned int> IRScope::findStructMemberIndex(const IRStruct structure,
   for (int i = StructMaps.size() - 1; i >= 0; i--) {
     for (const auto& pair : StructMaps[i]) {
 
-      if (pair.second.first == structure) {
-        auto it = pair.second.second.find(memberName);
-        if (it != pair.second.second.end()) {
+      if (pair.second.type == structure) {
+        auto it = pair.second.members.find(memberName);
+        if (it != pair.second.members.end()) {
           return it->second;
         }
       }
     }
   }
   return std::nullopt;
-}
\ No newline at end of file
+}
+
+optional<uint64_t> IRScope::findStructAlignment(const IRStruct structure) const {
+  for (int i = StructMaps.size() - 1; i >= 0; i--)
+    for (const auto& pair : StructMaps[i])
+      if (pair.second.type == structure)
+        return pair.second.alignment;
+  return std::nullopt;
+}
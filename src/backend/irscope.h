@@ -17,11 +17,25 @@
 
 // Using declarations
 using std::vector, std::string, std::unordered_map, std::optional;
-using IRVariable = llvm::AllocaInst*;
-using IRGlobalVariable = llvm::GlobalVariable*;
-using IRFunction = llvm::Function*;
 using IRStruct = llvm::StructType*;
 
+// Address of a variable and the type stored there: a global, an alloca of the function being
+// generated, or a pointer into the enclosing function's frame inside an outlined parallel loop body.
+// Pointer variables also keep the type they point to, which the pointer type doesn't carry
+struct IRVariable {
+  llvm::Value* address;
+  llvm::Type* type;
+  llvm::Type* pointee = nullptr;
+};
+
+// LLVM type of a struct, the field every member is stored in (#reorder can move them)
+// and the alignment of its variables (raised by #align, 1 for #packed structs)
+struct IRStructInfo {
+  IRStruct type;
+  unordered_map<string, unsigned int> members;
+  uint64_t alignment;
+};
+
 class IRScope {
 public:
 
@@ -34,26 +48,23 @@ public:
   void exitScope();
 
   // Global Variables
-  void declareGlobalVariable(const string& name, IRGlobalVariable globalVariable);
-  optional<IRGlobalVariable> findGlobalVariable(const string& name) const;
+  void declareGlobalVariable(const string& name, IRVariable globalVariable);
+  optional<IRVariable> findGlobalVariable(const string& name) const;
 
   // Local Variables
   void declareVariable(const string& name, IRVariable variable);
+  void declareVariable(const string& name, llvm::AllocaInst* variable);
   optional<IRVariable> findVariable(const string& name) const;
 
-  // Functions
-  void declareFunction(const string& name, IRFunction function);
-  optional<IRFunction> findFunction(const string& name) const;
-
   // Structs
-  void declareStruct(const string& name, std::pair<IRStruct, unordered_map<string, unsigned int>> structInfos);
+  void declareStruct(const string& name, IRStructInfo structInfos);
   optional<IRStruct> findStruct(const string& name) const;
   optional<unsigned int> findStructMemberIndex(const IRStruct structure, const string& memberName) const;
+  optional<uint64_t> findStructAlignment(const IRStruct structure) const;
 
 private:
-  unordered_map<string, IRGlobalVariable> globalVariableMaps;
+  unordered_map<string, IRVariable> globalVariableMaps;
   vector<unordered_map<string, IRVariable>> localVariableMaps;
-  vector<unordered_map<string, IRFunction>> FunctionMaps;
-  vector<unordered_map<string, std::pair<IRStruct, unordered_map<string, unsigned int>>>> StructMaps;
+  vector<unordered_map<string, IRStructInfo>> StructMaps;
 
 };
\ No newline at end of file
@@ -0,0 +1,257 @@
+#include "lto.h"
+
+#include <climits>
+#include <thread>
+#include <unordered_set>
+
+#include "llvm/Analysis/ModuleSummaryAnalysis.h"
+#include "llvm/Analysis/ProfileSummaryInfo.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/ModuleSummaryIndex.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Linker/Linker.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "emitter.h"
+#include "passes.h"
+
+using std::unordered_set;
+
+LinkTimeOptimizer::LinkTimeOptimizer(const Options& options): m_options(options) {
+  for (const string& path : options.getBitcodePaths()) {
+    llvm::ErrorOr<unique_ptr<llvm::MemoryBuffer>> buffer = llvm::MemoryBuffer::getFile(path);
+    if (!buffer)
+      error("Couldn't read the bitcode file " + path + ": " + buffer.getError().message());
+    m_buffers.push_back(std::move(*buffer));
+  }
+}
+
+LinkTimeOptimizer::LinkTimeOptimizer(const Options& options, vector<unique_ptr<llvm::MemoryBuffer>> buffers):
+  m_options(options), m_buffers(std::move(buffers)) {}
+
+unique_ptr<llvm::Module> LinkTimeOptimizer::link(llvm::LLVMContext& context) const {
+  ObjectEmitter::initializeTarget();
+
+  unique_ptr<llvm::Module> module = m_options.getLTOMode() == Options::LTO::THIN ? linkThin(context) : linkFull(context);
+  if (llvm::verifyModule(*module, &llvm::errs()))
+    error("The modules linked together don't make a valid module");
+  return module;
+}
+
+void LinkTimeOptimizer::writeBitcode(const llvm::Module& module, const Options& options) {
+  std::error_code code;
+  llvm::raw_fd_ostream output(options.getOutputPath(), code, llvm::sys::fs::OF_None);
+  if (code)
+    error("Couldn't open " + options.getOutputPath() + ": " + code.message());
+  writeBitcode(module, output, options);
+}
+
+void LinkTimeOptimizer::writeBitcode(const llvm::Module& module, llvm::raw_ostream& output, const Options& options) {
+  if (options.getLTOMode() == Options::LTO::THIN) {
+    llvm::ProfileSummaryInfo profile(module);
+    const llvm::ModuleSummaryIndex summary = llvm::buildModuleSummaryIndex(module, nullptr, &profile);
+    llvm::WriteBitcodeToFile(module, output, false, &summary);
+  }
+  else
+    llvm::WriteBitcodeToFile(module, output);
+}
+
+string LinkTimeOptimizer::getName(const size_t index) const {
+  return m_buffers[index]->getBufferIdentifier().str();
+}
+
+unique_ptr<llvm::Module> LinkTimeOptimizer::parse(const size_t index, llvm::LLVMContext& context) const {
+  llvm::Expected<unique_ptr<llvm::Module>> module = llvm::parseBitcodeFile(m_buffers[index]->getMemBufferRef(), context);
+  if (!module)
+    error("Couldn't read the bitcode file " + getName(index) + ": " + llvm::toString(module.takeError()));
+  return std::move(*module);
+}
+
+unique_ptr<llvm::Module> LinkTimeOptimizer::linkFull(llvm::LLVMContext& context) const {
+  unique_ptr<llvm::Module> module = parse(0, context);
+  llvm::Linker linker(*module);
+  for (size_t index = 1; index < m_buffers.size(); index++)
+    if (linker.linkInModule(parse(index, context)))
+      error("Couldn't link " + getName(index));
+
+  // Every module was already simplified on its own, an unoptimized build just links them
+  const llvm::OptimizationLevel level = getOptimizationLevel(m_options.getOptimizationLevel());
+  if (level == llvm::OptimizationLevel::O0)
+    return module;
+
+  unique_ptr<llvm::TargetMachine> targetMachine = ObjectEmitter::createTargetMachine(m_options.getOptimizationLevel());
+  llvm::PassBuilder passBuilder(targetMachine.get());
+  AnalysisManagers managers(passBuilder);
+  passBuilder.buildLTODefaultPipeline(level, nullptr).run(*module, managers.module);
+  return module;
+}
+
+// Every worker has its own context and optimizes its share of the modules, they're handed back
+// as bitcode like the partitions of --ir-threads
+unique_ptr<llvm::Module> LinkTimeOptimizer::linkThin(llvm::LLVMContext& context) const {
+  const unordered_map<string, Definition> definitions = readSummaries();
+  const llvm::OptimizationLevel level = getOptimizationLevel(m_options.getOptimizationLevel());
+
+  const size_t threads = std::max<size_t>(1, std::min<size_t>(m_options.getIRThreads(), m_buffers.size()));
+  vector<llvm::SmallVector<char, 0>> bitcodes(m_buffers.size());
+  vector<std::thread> workers;
+  for (size_t worker = 0; worker < threads; worker++) {
+    workers.emplace_back([&, worker]() {
+      llvm::LLVMContext workerContext;
+      unique_ptr<llvm::TargetMachine> targetMachine = ObjectEmitter::createTargetMachine(m_options.getOptimizationLevel());
+
+      for (size_t index = worker; index < m_buffers.size(); index += threads) {
+        unique_ptr<llvm::Module> module = parse(index, workerContext);
+        if (level != llvm::OptimizationLevel::O0) {
+          importFunctions(*module, index, definitions);
+
+          llvm::PassBuilder passBuilder(targetMachine.get());
+          AnalysisManagers managers(passBuilder);
+          passBuilder.buildThinLTODefaultPipeline(level, nullptr).run(*module, managers.module);
+        }
+
+        llvm::raw_svector_ostream output(bitcodes[index]);
+        llvm::WriteBitcodeToFile(*module, output);
+      }
+    });
+  }
+  for (std::thread& worker : workers)
+    worker.join();
+
+  // The imported copies were dropped by the optimizer, every function is left with one definition
+  unique_ptr<llvm::Module> module;
+  unique_ptr<llvm::Linker> linker;
+  for (size_t index = 0; index < bitcodes.size(); index++) {
+    llvm::MemoryBufferRef buffer(llvm::StringRef(bitcodes[index].data(), bitcodes[index].size()), getName(index));
+    llvm::Expected<unique_ptr<llvm::Module>> optimized = llvm::parseBitcodeFile(buffer, context);
+    if (!optimized)
+      error("Couldn't read back a module optimized with ThinLTO: " + llvm::toString(optimized.takeError()));
+
+    if (!module) {
+      module = std::move(*optimized);
+      linker = std::make_unique<llvm::Linker>(*module);
+    }
+    else if (linker->linkInModule(std::move(*optimized)))
+      error("Couldn't link " + getName(index));
+  }
+  return module;
+}
+
+// Module and size of every external function, the size comes from the summary built when the
+// module was compiled, so the bodies aren't read until a module imports from another one
+unordered_map<string, LinkTimeOptimizer::Definition> LinkTimeOptimizer::readSummaries() const {
+  unordered_map<string, Definition> definitions;
+  llvm::LLVMContext context;
+
+  for (size_t index = 0; index < m_buffers.size(); index++) {
+    const string& path = getName(index);
+    const llvm::MemoryBufferRef buffer = m_buffers[index]->getMemBufferRef();
+
+    llvm::Expected<llvm::BitcodeLTOInfo> info = llvm::getBitcodeLTOInfo(buffer);
+    if (!info)
+      error("Couldn't read the bitcode file " + path + ": " + llvm::toString(info.takeError()));
+    if (!info->HasSummary)
+      error("The bitcode file " + path + " has no summary, compile it with --lto=thin");
+
+    llvm::Expected<unique_ptr<llvm::ModuleSummaryIndex>> summary = llvm::getModuleSummaryIndex(buffer);
+    if (!summary)
+      error("Couldn't read the summary of " + path + ": " + llvm::toString(summary.takeError()));
+
+    llvm::Expected<unique_ptr<llvm::Module>> module = llvm::getLazyBitcodeModule(buffer, context);
+    if (!module)
+      error("Couldn't read the bitcode file " + path + ": " + llvm::toString(module.takeError()));
+
+    for (const llvm::Function& function : **module) {
+      if (function.isDeclaration() || function.hasLocalLinkage())
+        continue;
+
+      unsigned instructions = UINT_MAX;
+      if (const llvm::ValueInfo value = (*summary)->getValueInfo(function.getGUID()))
+        for (const unique_ptr<llvm::GlobalValueSummary>& global : value.getSummaryList())
+          if (const llvm::FunctionSummary* functionSummary = llvm::dyn_cast<llvm::FunctionSummary>(global.get()))
+            instructions = functionSummary->instCount();
+      definitions.emplace(function.getName().str(), Definition{ index, instructions });
+    }
+  }
+  return definitions;
+}
+
+// Locals of the module a function comes from aren't visible from the one it's imported into
+static bool isLocal(const llvm::Value* value) {
+  if (const llvm::GlobalValue* global = llvm::dyn_cast<llvm::GlobalValue>(value))
+    return global->hasLocalLinkage();
+  if (const llvm::Constant* constant = llvm::dyn_cast<llvm::Constant>(value))
+    for (const llvm::Value* operand : constant->operands())
+      if (isLocal(operand))
+        return true;
+  return false;
+}
+
+static bool referencesLocals(const llvm::Function& function) {
+  for (const llvm::BasicBlock& block : function)
+    for (const llvm::Instruction& instruction : block)
+      for (const llvm::Value* operand : instruction.operand_values())
+        if (isLocal(operand))
+          return true;
+  return false;
+}
+
+// Imported functions are linked in as available_externally: the inliner can use their bodies, then
+// they're dropped and the calls left go to the definition in the module they come from. Only the
+// declarations of the module pull functions in, along with what those functions need, everything
+// else of the other module is reduced to declarations or removed before it's linked
+void LinkTimeOptimizer::importFunctions(llvm::Module& module, const size_t index, const unordered_map<string, Definition>& definitions) const {
+  unordered_set<size_t> sources;
+  for (const llvm::Function& function : module) {
+    if (!function.isDeclaration() || function.isIntrinsic())
+      continue;
+    auto definition = definitions.find(function.getName().str());
+    if (definition != definitions.end() && definition->second.module != index && definition->second.instructions <= IMPORT_INSTRUCTION_LIMIT)
+      sources.insert(definition->second.module);
+  }
+
+  for (const size_t source : sources) {
+    unique_ptr<llvm::Module> imported = parse(source, module.getContext());
+
+    // Bodies are decided upfront, dropping one can leave another without references to locals
+    unordered_set<const llvm::Function*> available;
+    for (const llvm::Function& function : *imported) {
+      auto definition = definitions.find(function.getName().str());
+      if (definition != definitions.end() && definition->second.module == source && definition->second.instructions <= IMPORT_INSTRUCTION_LIMIT && !referencesLocals(function))
+        available.insert(&function);
+    }
+
+    for (llvm::Function& function : *imported) {
+      if (available.count(&function))
+        function.setLinkage(llvm::GlobalValue::AvailableExternallyLinkage);
+      else if (!function.isDeclaration())
+        function.deleteBody();
+    }
+
+    // Constants keep their value so it can be folded, variables are defined by their own module
+    for (llvm::GlobalVariable& global : imported->globals()) {
+      if (global.isConstant() && !global.hasLocalLinkage() && !global.isDeclaration())
+        global.setLinkage(llvm::GlobalValue::AvailableExternallyLinkage);
+      else
+        global.setInitializer(nullptr);
+    }
+
+    // Nothing left references the locals
+    for (llvm::Function& function : llvm::make_early_inc_range(*imported)) {
+      function.removeDeadConstantUsers();
+      if (function.hasLocalLinkage() && function.use_empty())
+        function.eraseFromParent();
+    }
+    for (llvm::GlobalVariable& global : llvm::make_early_inc_range(imported->globals())) {
+      global.removeDeadConstantUsers();
+      if (global.hasLocalLinkage() && global.use_empty())
+        global.eraseFromParent();
+    }
+
+    if (llvm::Linker::linkModules(module, std::move(imported), llvm::Linker::Flags::LinkOnlyNeeded))
+      error("Couldn't import functions from " + getName(source) + " into " + getName(index));
+  }
+}
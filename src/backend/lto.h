@@ -0,0 +1,60 @@
+#pragma once
+
+// C++ Headers
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+
+// LLVM Headers
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+// Compiler Headers
+#include "../includes/error.hpp"
+#include "../includes/options.hpp"
+
+// Using declarations
+using std::string, std::unordered_map, std::vector, std::unique_ptr;
+
+// Link time optimization of modules compiled one by one to bitcode with -o <file.bc>, a
+// module calls the functions of the others through declarations without a body. Full LTO
+// links them into a single module and runs the LTO pipeline over the whole program. ThinLTO
+// keeps them apart: every module imports from the others the small functions it calls, picked
+// with the summaries written next to the bitcode, so the inliner can see through them. Then
+// the modules are optimized on their own, in parallel, and linked once they're done
+class LinkTimeOptimizer {
+public:
+  // Functions with more instructions than this aren't imported, like LLVM's -import-instr-limit
+  static constexpr unsigned IMPORT_INSTRUCTION_LIMIT = 100;
+
+  // Constructors, the modules are read from the bitcode files given to the compiler or were
+  // just compiled from several sources, named after the files they come from
+  LinkTimeOptimizer(const Options& options);
+  LinkTimeOptimizer(const Options& options, vector<unique_ptr<llvm::MemoryBuffer>> buffers);
+
+  unique_ptr<llvm::Module> link(llvm::LLVMContext& context) const;
+
+  // Writes the module to the -o path or to a stream, with its summary for ThinLTO
+  static void writeBitcode(const llvm::Module& module, const Options& options);
+  static void writeBitcode(const llvm::Module& module, llvm::raw_ostream& output, const Options& options);
+
+private:
+  // External function of one of the modules, with its size in the summary
+  struct Definition {
+    size_t module;
+    unsigned instructions;
+  };
+
+  const Options& m_options;
+  vector<unique_ptr<llvm::MemoryBuffer>> m_buffers;
+
+  unique_ptr<llvm::Module> linkFull(llvm::LLVMContext& context) const;
+  unique_ptr<llvm::Module> linkThin(llvm::LLVMContext& context) const;
+  unordered_map<string, Definition> readSummaries() const;
+  void importFunctions(llvm::Module& module, const size_t index, const unordered_map<string, Definition>& definitions) const;
+  string getName(const size_t index) const;
+  unique_ptr<llvm::Module> parse(const size_t index, llvm::LLVMContext& context) const;
+};
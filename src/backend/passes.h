@@ -0,0 +1,38 @@
+#pragma once
+
+// LLVM Headers
+#include "llvm/Passes/OptimizationLevel.h"
+#include "llvm/Passes/PassBuilder.h"
+
+// Analysis managers wired together the way the PassBuilder expects them
+struct AnalysisManagers {
+  llvm::LoopAnalysisManager loop;
+  llvm::FunctionAnalysisManager function;
+  llvm::CGSCCAnalysisManager cgscc;
+  llvm::ModuleAnalysisManager module;
+
+  AnalysisManagers(llvm::PassBuilder& passBuilder) {
+    passBuilder.registerModuleAnalyses(module);
+    passBuilder.registerCGSCCAnalyses(cgscc);
+    passBuilder.registerFunctionAnalyses(function);
+    passBuilder.registerLoopAnalyses(loop);
+    passBuilder.crossRegisterProxies(loop, function, cgscc, module);
+  }
+};
+
+// Pipeline level of -O<0-3>
+inline llvm::OptimizationLevel getOptimizationLevel(const unsigned level) {
+  switch (level) {
+    case 0:
+      return llvm::OptimizationLevel::O0;
+
+    case 1:
+      return llvm::OptimizationLevel::O1;
+
+    case 2:
+      return llvm::OptimizationLevel::O2;
+
+    default:
+      return llvm::OptimizationLevel::O3;
+  }
+}
@@ -0,0 +1,60 @@
+#include "profile.h"
+
+#include "llvm/Config/llvm-config.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/ProfileData/InstrProf.h"
+#include "llvm/ProfileData/InstrProfWriter.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+
+static constexpr llvm::StringRef COUNTERS_PREFIX = "__profc_";
+static constexpr llvm::StringRef DATA_PREFIX = "__profd_";
+
+// Every instrumented function has an array of counters and a data record, the hash is
+// its second field in every version of the raw profile format
+ProfileCollector::ProfileCollector(llvm::Module& module) {
+  for (llvm::GlobalVariable& global : module.globals()) {
+    llvm::StringRef name = global.getName();
+    if (!name.consume_front(COUNTERS_PREFIX))
+      continue;
+
+    const llvm::GlobalVariable* data = module.getNamedGlobal((DATA_PREFIX + name).str());
+    if (!data || !data->hasInitializer())
+      error("The profile data of " + name.str() + " is missing from the instrumented module");
+
+    const llvm::ConstantInt* hash = llvm::cast<llvm::ConstantInt>(data->getInitializer()->getAggregateElement(1u));
+    const uint64_t size = llvm::cast<llvm::ArrayType>(global.getValueType())->getNumElements();
+    m_functions.push_back({ name.str(), hash->getZExtValue(), size });
+    global.setLinkage(llvm::GlobalValue::ExternalLinkage);
+  }
+}
+
+bool ProfileCollector::isEmpty() const {
+  return m_functions.empty();
+}
+
+void ProfileCollector::write(llvm::ExecutionEngine& engine, const string& path) const {
+  llvm::InstrProfWriter writer;
+#if LLVM_VERSION_MAJOR >= 15
+  if (llvm::Error kind = writer.mergeProfileKind(llvm::InstrProfKind::IRInstrumentation))
+#else
+  if (llvm::Error kind = writer.mergeProfileKind(llvm::InstrProfKind::IR))
+#endif
+    error("Couldn't set the kind of the profile: " + llvm::toString(std::move(kind)));
+
+  for (const FunctionCounters& function : m_functions) {
+    const uint64_t* counters = reinterpret_cast<const uint64_t*>(engine.getGlobalValueAddress((COUNTERS_PREFIX + function.name).str()));
+    if (!counters)
+      error("Couldn't find the profile counters of " + function.name + " in the JIT");
+
+    writer.addRecord(llvm::NamedInstrProfRecord(function.name, function.hash, vector<uint64_t>(counters, counters + function.size)), 1,
+      [&function](llvm::Error problem){ warning("Profile of " + function.name + ": " + llvm::toString(std::move(problem))); });
+  }
+
+  std::error_code ec;
+  llvm::raw_fd_ostream output(path, ec, llvm::sys::fs::OF_None);
+  if (ec)
+    error("Couldn't open the profile " + path + ": " + ec.message());
+  if (llvm::Error problem = writer.write(output))
+    error("Couldn't write the profile " + path + ": " + llvm::toString(std::move(problem)));
+}
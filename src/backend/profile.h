@@ -0,0 +1,40 @@
+#pragma once
+
+// C++ Headers
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// LLVM Headers
+#include "llvm/ExecutionEngine/ExecutionEngine.h"
+#include "llvm/IR/Module.h"
+
+// Compiler Headers
+#include "../includes/error.hpp"
+
+// Using declarations
+using std::string, std::vector;
+
+// Counters of a module instrumented with --profile-generate and run with the JIT. The
+// compiler-rt runtime that writes the raw profile of linked programs isn't part of the
+// compiler, so once main returns the counters are read back from the JIT memory and
+// written as an indexed profile, which --profile-use reads without llvm-profdata merge
+class ProfileCollector {
+public:
+
+  // Constructor, to be called before the module is handed to the JIT. The counters
+  // are private to the module, they're exported so the JIT can find them by name
+  ProfileCollector(llvm::Module& module);
+
+  bool isEmpty() const;
+  void write(llvm::ExecutionEngine& engine, const string& path) const;
+
+private:
+  struct FunctionCounters {
+    string name;    // PGO name of the function, the lowering names its counters after it
+    uint64_t hash;  // hash of the control flow graph the counters were placed on
+    uint64_t size;
+  };
+
+  vector<FunctionCounters> m_functions;
+};
@@ -0,0 +1,186 @@
+#include "constant.h"
+
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+#include "../includes/nodes/ASTNode.h"
+#include "../includes/nodes/literal.h"
+#include "../includes/nodes/type.h"
+
+bool Constant::isInteger() const {
+  return !isFloat();
+}
+
+bool Constant::isFloat() const {
+  return type == ASTNodeType::LITERAL_FLOAT || type == ASTNodeType::FLOAT || type == ASTNodeType::FLOAT32 || type == ASTNodeType::FLOAT64;
+}
+
+int64_t Constant::getSigned() const {
+  return static_cast<int64_t>(integer);
+}
+
+// Pointers and vectors are never folded, the other scalars always can be
+bool Constant::IsFoldable(const ASTNodeType type) {
+  return Type::GetBitWidth(type) != 0;
+}
+
+Constant Constant::Integer(const ASTNodeType type, const uint64_t value) {
+  const unsigned bits = Type::GetBitWidth(type);
+  if (bits >= 64)
+    return { type, value, 0 };
+
+  const uint64_t mask = (uint64_t(1) << bits) - 1;
+  const bool isNegative = !Type::IsUnsigned(type) && ((value >> (bits - 1)) & 1);
+  return { type, isNegative ? value | ~mask : value & mask, 0 };
+}
+
+Constant Constant::Float(const ASTNodeType type, const double value) {
+  return { type, 0, type == ASTNodeType::FLOAT32 ? static_cast<double>(static_cast<float>(value)) : value };
+}
+
+optional<Constant> Constant::Of(const ASTNode* node) {
+  const Literal* literal = dynamic_cast<const Literal*>(node);
+  if (!literal)
+    return node->getConstant();
+
+  const string text = literal->toString();
+  switch (node->getNodeType()) {
+    case ASTNodeType::LITERAL_INTEGER: {
+      errno = 0;
+      const uint64_t value = text[0] == '-' ? static_cast<uint64_t>(std::strtoll(text.c_str(), nullptr, 10)) : std::strtoull(text.c_str(), nullptr, 10);
+      if (errno == ERANGE)
+        return std::nullopt;
+      return Constant{ ASTNodeType::LITERAL_INTEGER, value, 0 };
+    }
+
+    case ASTNodeType::LITERAL_FLOAT:
+      return Constant{ ASTNodeType::LITERAL_FLOAT, 0, std::strtod(text.c_str(), nullptr) };
+
+    // The lexeme keeps the quotes around the character
+    case ASTNodeType::LITERAL_CHARACTER:
+      return Integer(ASTNodeType::CHAR, static_cast<unsigned char>(text[1]));
+
+    case ASTNodeType::LITERAL_BOOLEAN:
+      return Integer(ASTNodeType::BOOL, text[0] == 't');
+
+    default:
+      return std::nullopt;
+  }
+}
+
+// Same conversions as Codegen::generateConversion, literals are built directly with the target type
+optional<Constant> Constant::Convert(const optional<Constant>& value, const ASTNodeType to) {
+  if (!value || !IsFoldable(to))
+    return std::nullopt;
+
+  const bool isSourceUnsigned = value->type == ASTNodeType::LITERAL_INTEGER ? value->getSigned() >= 0 : Type::IsUnsigned(value->type);
+  const bool isTargetFloat = Constant{ to }.isFloat();
+
+  if (to == ASTNodeType::BOOL) {
+    if (value->isFloat())
+      return Integer(to, !std::isnan(value->floating) && value->floating != 0);
+    return Integer(to, value->integer != 0);
+  }
+
+  if (value->isInteger()) {
+    if (!isTargetFloat)
+      return Integer(to, value->integer);
+    if (to == ASTNodeType::FLOAT32)
+      return Float(to, isSourceUnsigned ? static_cast<float>(value->integer) : static_cast<float>(value->getSigned()));
+    return Float(to, isSourceUnsigned ? static_cast<double>(value->integer) : static_cast<double>(value->getSigned()));
+  }
+
+  if (isTargetFloat)
+    return Float(to, value->floating);
+
+  // Floats that don't fit the integer type convert to poison, they aren't folded
+  const unsigned bits = Type::GetBitWidth(to);
+  const double truncated = std::trunc(value->floating);
+  const bool isUnsigned = Type::IsUnsigned(to);
+  const double lowest = isUnsigned ? 0 : -std::ldexp(1.0, bits - 1);
+  const double limit = std::ldexp(1.0, isUnsigned ? bits : bits - 1);
+  if (std::isnan(truncated) || truncated < lowest || truncated >= limit)
+    return std::nullopt;
+
+  return Integer(to, isUnsigned ? static_cast<uint64_t>(truncated) : static_cast<uint64_t>(static_cast<int64_t>(truncated)));
+}
+
+// Same operations as Codegen::generateOperation: integers wrap around, float comparisons are unordered
+optional<Constant> Constant::FoldBinary(const enum TokenType op, const optional<Constant>& leftValue, const optional<Constant>& rightValue, const ASTNodeType operandType) {
+  const optional<Constant> left = Convert(leftValue, operandType);
+  const optional<Constant> right = Convert(rightValue, operandType);
+  if (!left || !right)
+    return std::nullopt;
+
+  if (left->isFloat()) {
+    const double a = left->floating, b = right->floating;
+    const bool isUnordered = std::isnan(a) || std::isnan(b);
+
+    switch (op) {
+      case TokenType::EQUALS:        return Integer(ASTNodeType::BOOL, isUnordered || a == b);
+      case TokenType::NOT_EQUAL:     return Integer(ASTNodeType::BOOL, isUnordered || a != b);
+      case TokenType::GREATER:       return Integer(ASTNodeType::BOOL, isUnordered || a > b);
+      case TokenType::LESS:          return Integer(ASTNodeType::BOOL, isUnordered || a < b);
+      case TokenType::GREATER_EQUAL: return Integer(ASTNodeType::BOOL, isUnordered || a >= b);
+      case TokenType::LESS_EQUAL:    return Integer(ASTNodeType::BOOL, isUnordered || a <= b);
+      case TokenType::ADDITION:      return Float(operandType, a + b);
+      case TokenType::SUBTRACTION:   return Float(operandType, a - b);
+      case TokenType::STAR:          return Float(operandType, a * b);
+      case TokenType::DIVISION:      return Float(operandType, a / b);
+      case TokenType::MODULUS:       return Float(operandType, std::fmod(a, b));
+      default:                       return std::nullopt;
+    }
+  }
+
+  const bool isUnsigned = Type::IsUnsigned(operandType);
+  const uint64_t a = left->integer, b = right->integer;
+  const int64_t signedA = left->getSigned(), signedB = right->getSigned();
+
+  // The smallest value of the type divided by -1 overflows, like a division by zero it's undefined
+  const unsigned bits = Type::GetBitWidth(operandType);
+  const bool isDivisionUndefined = b == 0 || (!isUnsigned && signedB == -1 && a == Integer(operandType, uint64_t(1) << (bits - 1)).integer);
+
+  switch (op) {
+    case TokenType::EQUALS:        return Integer(ASTNodeType::BOOL, a == b);
+    case TokenType::NOT_EQUAL:     return Integer(ASTNodeType::BOOL, a != b);
+    case TokenType::GREATER:       return Integer(ASTNodeType::BOOL, isUnsigned ? a > b : signedA > signedB);
+    case TokenType::LESS:          return Integer(ASTNodeType::BOOL, isUnsigned ? a < b : signedA < signedB);
+    case TokenType::GREATER_EQUAL: return Integer(ASTNodeType::BOOL, isUnsigned ? a >= b : signedA >= signedB);
+    case TokenType::LESS_EQUAL:    return Integer(ASTNodeType::BOOL, isUnsigned ? a <= b : signedA <= signedB);
+    case TokenType::ADDITION:      return Integer(operandType, a + b);
+    case TokenType::SUBTRACTION:   return Integer(operandType, a - b);
+    case TokenType::STAR:          return Integer(operandType, a * b);
+
+    case TokenType::DIVISION:
+      if (isDivisionUndefined)
+        return std::nullopt;
+      return Integer(operandType, isUnsigned ? a / b : static_cast<uint64_t>(signedA / signedB));
+
+    case TokenType::MODULUS:
+      if (isDivisionUndefined)
+        return std::nullopt;
+      return Integer(operandType, isUnsigned ? a % b : static_cast<uint64_t>(signedA % signedB));
+
+    default:
+      return std::nullopt;
+  }
+}
+
+optional<Constant> Constant::FoldNot(const optional<Constant>& value) {
+  if (!value || value->type != ASTNodeType::BOOL)
+    return std::nullopt;
+  return Integer(ASTNodeType::BOOL, value->integer == 0);
+}
+
+// A left operand that decides the result folds even when the right one isn't known, it wouldn't be evaluated
+optional<Constant> Constant::FoldLogical(const enum TokenType op, const optional<Constant>& left, const optional<Constant>& right) {
+  if (!left || left->type != ASTNodeType::BOOL)
+    return std::nullopt;
+  if ((left->integer != 0) == (op == TokenType::OR))
+    return left;
+  if (!right || right->type != ASTNodeType::BOOL)
+    return std::nullopt;
+  return right;
+}
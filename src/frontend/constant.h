@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#include "../includes/ASTNodeType.h"
+#include "../includes/token.hpp"
+
+using std::optional;
+
+class ASTNode;
+
+// Value of an expression known at compile time. Integers are kept in 64 bits, wrapped to the
+// width of their type and extended like it, floats are doubles rounded to their type precision.
+// Literals have the type LITERAL_INTEGER/LITERAL_FLOAT until they're converted to the type
+// they're used with, like the codegen does when it builds them
+struct Constant {
+  ASTNodeType type;
+  uint64_t integer = 0;
+  double floating = 0;
+
+  bool isInteger() const;
+  bool isFloat() const;
+  int64_t getSigned() const;
+
+  // Every function returns nullopt when the result isn't known or is undefined (division by
+  // zero, a float out of the range of an integer...), so it's left to the generated code
+  static optional<Constant> Of(const ASTNode* node);
+  static optional<Constant> Convert(const optional<Constant>& value, const ASTNodeType to);
+  static optional<Constant> FoldBinary(const enum TokenType op, const optional<Constant>& left, const optional<Constant>& right, const ASTNodeType operandType);
+  static optional<Constant> FoldNot(const optional<Constant>& value);
+  static optional<Constant> FoldLogical(const enum TokenType op, const optional<Constant>& left, const optional<Constant>& right);
+  static bool IsFoldable(const ASTNodeType type);
+
+private:
+  static Constant Integer(const ASTNodeType type, const uint64_t value);
+  static Constant Float(const ASTNodeType type, const double value);
+};
@@ -0,0 +1,560 @@
+#include "interface.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "constant.h"
+#include "preprocessing.hpp"
+#include "tokenizer.hpp"
+#include "parser.hpp"
+
+namespace fs = std::filesystem;
+
+static constexpr char MAGIC[] = "SHQI";
+
+// FNV-1a, the interfaces only need to notice that a source changed
+static uint64_t Hash(const string_view bytes, uint64_t hash = 14695981039346656037ull) {
+  for (const char byte : bytes) {
+    hash ^= static_cast<unsigned char>(byte);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+static string ReadFile(const string& path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open())
+    return "";
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  return buffer.str();
+}
+
+vector<shared_ptr<const ModuleInterface>> ModuleInterface::ImportAll(const vector<Token>& tokens, size_t& index, const string& path) {
+  const fs::path directory = fs::path(path).parent_path();
+
+  vector<shared_ptr<const ModuleInterface>> interfaces;
+  while (index < tokens.size() && tokens[index].type == TokenType::IMPORT) {
+    const size_t line = tokens[index++].line;
+    if (index >= tokens.size() || tokens[index].type != TokenType::LITERAL_STRING)
+      error("In import was expected the path of the module as a string", line);
+    const string& literal = tokens[index++].lexemes;
+    if (index >= tokens.size() || tokens[index].type != TokenType::SEMICOLON)
+      error("In import was expected a semicolon after the path of the module", line);
+    index++;
+
+    // The lexeme keeps the quotes around the path
+    const fs::path imported = directory / literal.substr(1, literal.size() - 2);
+    std::error_code code;
+    if (!fs::is_regular_file(imported, code))
+      error("Couldn't find the module " + imported.string() + " imported by " + (path.empty() ? "the program" : path), line);
+    interfaces.push_back(Import(fs::weakly_canonical(imported).string()));
+  }
+  return interfaces;
+}
+
+// Every module is read once per thread. The modules being imported are kept in a stack, finding
+// one of them again means they import each other
+shared_ptr<const ModuleInterface> ModuleInterface::Import(const string& path) {
+  thread_local unordered_map<string, shared_ptr<const ModuleInterface>> imported;
+  thread_local vector<string> importing;
+
+  auto found = imported.find(path);
+  if (found != imported.end())
+    return found->second;
+
+  if (std::find(importing.begin(), importing.end(), path) != importing.end()) {
+    string cycle;
+    for (auto module = std::find(importing.begin(), importing.end(), path); module != importing.end(); module++)
+      cycle += *module + " -> ";
+    error("Modules can't import each other: " + cycle + path);
+  }
+
+  importing.push_back(path);
+  const uint64_t sourceHash = Hash(ReadFile(path));
+  optional<ModuleInterface> interface = Load(path, sourceHash);
+  if (!interface) {
+    interface = Build(path, sourceHash);
+    interface->store();
+  }
+  importing.pop_back();
+
+  return imported.emplace(path, std::make_shared<const ModuleInterface>(std::move(*interface))).first->second;
+}
+
+// The interface written before is only used when the source and every module it imports is
+// still the same, the imports are checked first, their interfaces may have to be rebuilt too
+optional<ModuleInterface> ModuleInterface::Load(const string& path, const uint64_t sourceHash) {
+  const string bytes = ReadFile(GetInterfacePath(path));
+  if (bytes.empty())
+    return std::nullopt;
+
+  ModuleInterface interface;
+  interface.m_path = path;
+  if (!interface.deserialize(bytes)) {
+    warning("The interface of " + path + " is corrupted or was written by another version, it's built again");
+    return std::nullopt;
+  }
+
+  vector<std::pair<string, uint64_t>> imports;
+  for (const auto& [module, key] : interface.m_imports) {
+    std::error_code code;
+    if (!fs::is_regular_file(module, code))
+      return std::nullopt;
+    imports.emplace_back(module, Import(module)->getKey());
+  }
+
+  if (GetKey(sourceHash, imports) != interface.m_key)
+    return std::nullopt;
+  return interface;
+}
+
+ModuleInterface ModuleInterface::Build(const string& path, const uint64_t sourceHash) {
+  const string importerPath = diagnosticSourcePath;
+  diagnosticSourcePath = path;
+
+  Preprocessor preprocessed(path);
+  Tokenizer tokenizer(preprocessed.getSrc());
+  Parser parser(tokenizer.getTokens(), path, true);
+
+  ModuleInterface interface;
+  interface.m_path = path;
+  interface.read(parser);
+  interface.m_key = GetKey(sourceHash, interface.m_imports);
+
+  diagnosticSourcePath = importerPath;
+  return interface;
+}
+
+uint64_t ModuleInterface::GetKey(const uint64_t sourceHash, const vector<std::pair<string, uint64_t>>& imports) {
+  uint64_t key = Hash(string_view(reinterpret_cast<const char*>(&VERSION), sizeof(VERSION)));
+  key = Hash(string_view(reinterpret_cast<const char*>(&sourceHash), sizeof(sourceHash)), key);
+  for (const auto& [path, importKey] : imports)
+    key = Hash(string_view(reinterpret_cast<const char*>(&importKey), sizeof(importKey)), Hash(path, key));
+  return key;
+}
+
+string ModuleInterface::GetInterfacePath(const string& path) {
+  return fs::path(path).replace_extension(".shqi").string();
+}
+
+const string& ModuleInterface::getPath() const {
+  return m_path;
+}
+
+uint64_t ModuleInterface::getKey() const {
+  return m_key;
+}
+
+// Values known at compile time written back as literals of the type they were converted to
+static ModuleInterface::Value ToLiteral(const Constant& constant) {
+  if (constant.type == ASTNodeType::BOOL)
+    return { TokenType::LITERAL_BOOLEAN, constant.integer ? "true" : "false" };
+  if (constant.type == ASTNodeType::CHAR)
+    return { TokenType::LITERAL_CHARACTER, string("'") + static_cast<char>(constant.integer) + "'" };
+
+  if (constant.isFloat()) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.17g", constant.floating);
+    string lexeme = text;
+    if (lexeme.find_first_of(".eni") == string::npos)
+      lexeme += ".0";
+    return { TokenType::LITERAL_FLOAT, lexeme };
+  }
+
+  return { TokenType::LITERAL_INTEGER, Type::IsUnsigned(constant.type) ? std::to_string(constant.integer) : std::to_string(constant.getSigned()) };
+}
+
+// Returns nullopt when a value isn't known at compile time, like a pointer or a struct
+static optional<ModuleInterface::Declaration> ReadDeclaration(const Variable& variable) {
+  ModuleInterface::Declaration declaration{ variable.isConstant(), variable.getTypeToString(), variable.isPointer(), variable.getArraySize(), variable.getIdentifier(), false, {} };
+
+  const ASTNode* value = variable.getValue();
+  if (value->getNodeType() == ASTNodeType::NOTHING)
+    return declaration;
+
+  vector<const ASTNode*> elements;
+  if (const ListInitializer* list = dynamic_cast<const ListInitializer*>(value)) {
+    declaration.isList = true;
+    for (const Expression* element : list->getList())
+      elements.push_back(element->getASTNode());
+  }
+  else
+    elements.push_back(value);
+
+  // Scalars given to a vector are splat, they have the type of a lane
+  for (const ASTNode* element : elements) {
+    const optional<Constant> constant = Constant::Convert(Constant::Of(element), Type::GetElementType(variable.getType()));
+    if (variable.isPointer() || !constant)
+      return std::nullopt;
+    declaration.values.push_back(ToLiteral(*constant));
+  }
+  return declaration;
+}
+
+// Structs are all kept, the ones imported too: the signatures of the module can use them. The
+// functions and constants are only the ones of the module, they aren't imported again
+void ModuleInterface::read(const Parser& parser) {
+  for (const shared_ptr<const ModuleInterface>& import : parser.getImports())
+    m_imports.emplace_back(import->getPath(), import->getKey());
+
+  const vector<unique_ptr<ASTNode>>& ast = parser.getAST();
+  for (size_t index = 0; index < ast.size(); index++) {
+    if (const Struct* structure = dynamic_cast<const Struct*>(ast[index].get())) {
+      Structure record{ structure->getIdentifier(), {}, {} };
+      for (const unique_ptr<Annotation>& annotation : structure->getAnnotations())
+        record.annotations.emplace_back(annotation->getName(), annotation->getArgument());
+      for (const Variable* member : structure->getMembers()) {
+        optional<Declaration> declaration = ReadDeclaration(*member);
+        if (!declaration)
+          error("The default value of " + structure->getIdentifier() + "." + member->getIdentifier() + " isn't known at compile time, it can't be written to the interface of " + m_path);
+        record.members.push_back(std::move(*declaration));
+      }
+      m_structures.push_back(std::move(record));
+      continue;
+    }
+
+    if (index < parser.getImportedCount())
+      continue;
+
+    // A const fn is evaluated by the module that calls it, that takes its body
+    if (const Function* function = dynamic_cast<const Function*>(ast[index].get())) {
+      if (!function->findAnnotation("export") || function->isConstant())
+        continue;
+
+      Signature signature{ function->getReturnType()->toString(), function->getReturnType()->isPointer(), function->getIdentifier()->toString(), {} };
+      for (const Parameter* parameter : function->getParameter())
+        signature.arguments.push_back({ parameter->getTypeToString(), Type::IsPointer(parameter->getType()), parameter->isRestrict(), parameter->getIdentifier() });
+      m_functions.push_back(std::move(signature));
+    }
+    else if (const Variable* variable = dynamic_cast<const Variable*>(ast[index].get())) {
+      if (!variable->isConstant() || variable->getStructure())
+        continue;
+      if (optional<Declaration> declaration = ReadDeclaration(*variable))
+        m_constants.push_back(std::move(*declaration));
+    }
+  }
+}
+
+// The declarations are rebuilt as the tokens the parser would have read, the imported ones
+// don't have a line in the importing module
+static void AppendType(vector<Token>& tokens, const string& type, const bool isPointer) {
+  auto keyword = keywordMap.find(type);
+  tokens.emplace_back(keyword != keywordMap.end() ? keyword->second : TokenType::IDENTIFIER, type, 0);
+  if (isPointer)
+    tokens.emplace_back(TokenType::STAR, "*", 0);
+}
+
+static void AppendDeclaration(vector<Token>& tokens, const ModuleInterface::Declaration& declaration) {
+  tokens.emplace_back(declaration.isConstant ? TokenType::CONSTANT : TokenType::VAR, declaration.isConstant ? "const" : "var", 0);
+  AppendType(tokens, declaration.type, declaration.isPointer);
+  if (declaration.arraySize) {
+    tokens.emplace_back(TokenType::LBRACKET, "[", 0);
+    tokens.emplace_back(TokenType::LITERAL_INTEGER, std::to_string(declaration.arraySize), 0);
+    tokens.emplace_back(TokenType::RBRACKET, "]", 0);
+  }
+  tokens.emplace_back(TokenType::IDENTIFIER, declaration.name, 0);
+
+  if (declaration.isList || !declaration.values.empty()) {
+    tokens.emplace_back(TokenType::ASSIGNMENT, "=", 0);
+    if (declaration.isList)
+      tokens.emplace_back(TokenType::LCURLY, "{", 0);
+    for (size_t index = 0; index < declaration.values.size(); index++) {
+      if (index > 0)
+        tokens.emplace_back(TokenType::COMMA, ",", 0);
+      tokens.emplace_back(declaration.values[index].type, declaration.values[index].lexeme, 0);
+    }
+    if (declaration.isList)
+      tokens.emplace_back(TokenType::RCURLY, "}", 0);
+  }
+  tokens.emplace_back(TokenType::SEMICOLON, ";", 0);
+}
+
+size_t ModuleInterface::appendDeclarations(vector<Token>& tokens, unordered_map<string, string>& structs) const {
+  size_t declarations = 0;
+
+  for (const Structure& structure : m_structures) {
+    const string layout = SerializeStructure(structure);
+    auto [declared, isNew] = structs.emplace(structure.name, layout);
+    if (!isNew) {
+      if (declared->second != layout)
+        error("The struct " + structure.name + " of " + m_path + " doesn't match another struct imported with the same name");
+      continue;
+    }
+
+    for (const auto& [name, argument] : structure.annotations) {
+      tokens.emplace_back(TokenType::ANNOTATION, name, 0);
+      if (argument) {
+        tokens.emplace_back(TokenType::LPAREN, "(", 0);
+        tokens.emplace_back(TokenType::LITERAL_INTEGER, std::to_string(*argument), 0);
+        tokens.emplace_back(TokenType::RPAREN, ")", 0);
+      }
+    }
+    tokens.emplace_back(TokenType::STRUCT, "struct", 0);
+    tokens.emplace_back(TokenType::IDENTIFIER, structure.name, 0);
+    tokens.emplace_back(TokenType::LCURLY, "{", 0);
+    for (const Declaration& member : structure.members)
+      AppendDeclaration(tokens, member);
+    tokens.emplace_back(TokenType::RCURLY, "}", 0);
+    tokens.emplace_back(TokenType::SEMICOLON, ";", 0);
+    declarations++;
+  }
+
+  for (const Declaration& constant : m_constants)
+    AppendDeclaration(tokens, constant);
+
+  for (const Signature& function : m_functions) {
+    tokens.emplace_back(TokenType::FUNC, "fn", 0);
+    AppendType(tokens, function.returnType, function.isPointer);
+    tokens.emplace_back(TokenType::IDENTIFIER, function.name, 0);
+    tokens.emplace_back(TokenType::LPAREN, "(", 0);
+    for (size_t index = 0; index < function.arguments.size(); index++) {
+      const Argument& argument = function.arguments[index];
+      if (index > 0)
+        tokens.emplace_back(TokenType::COMMA, ",", 0);
+      AppendType(tokens, argument.type, argument.isPointer);
+      if (argument.isRestrict)
+        tokens.emplace_back(TokenType::RESTRICT, "restrict", 0);
+      tokens.emplace_back(TokenType::IDENTIFIER, argument.name, 0);
+    }
+    tokens.emplace_back(TokenType::RPAREN, ")", 0);
+    tokens.emplace_back(TokenType::SEMICOLON, ";", 0);
+  }
+
+  return declarations + m_constants.size() + m_functions.size();
+}
+
+// Little endian, strings are prefixed with their size
+class InterfaceWriter {
+public:
+  void write(const uint64_t value, const size_t bytes) {
+    for (size_t byte = 0; byte < bytes; byte++)
+      m_bytes.push_back(static_cast<char>((value >> (8 * byte)) & 0xFF));
+  }
+
+  void write(const string& text) {
+    write(text.size(), 4);
+    m_bytes += text;
+  }
+
+  void append(const string& bytes) {
+    m_bytes += bytes;
+  }
+
+  const string& getBytes() const {
+    return m_bytes;
+  }
+
+private:
+  string m_bytes;
+};
+
+// Every read checks the size left, a truncated file makes the reader fail instead of the compiler
+class InterfaceReader {
+public:
+  InterfaceReader(const string& bytes): m_bytes(bytes) {}
+
+  uint64_t read(const size_t bytes) {
+    if (m_offset + bytes > m_bytes.size()) {
+      m_isValid = false;
+      return 0;
+    }
+    uint64_t value = 0;
+    for (size_t byte = 0; byte < bytes; byte++)
+      value |= static_cast<uint64_t>(static_cast<unsigned char>(m_bytes[m_offset++])) << (8 * byte);
+    return value;
+  }
+
+  string readString() {
+    const size_t size = read(4);
+    if (m_offset + size > m_bytes.size()) {
+      m_isValid = false;
+      return "";
+    }
+    m_offset += size;
+    return m_bytes.substr(m_offset - size, size);
+  }
+
+  bool isValid() const {
+    return m_isValid;
+  }
+
+  bool isAtEnd() const {
+    return m_offset == m_bytes.size();
+  }
+
+private:
+  const string& m_bytes;
+  size_t m_offset = 0;
+  bool m_isValid = true;
+};
+
+static void WriteDeclaration(InterfaceWriter& writer, const ModuleInterface::Declaration& declaration) {
+  writer.write(declaration.isConstant, 1);
+  writer.write(declaration.type);
+  writer.write(declaration.isPointer, 1);
+  writer.write(declaration.arraySize, 8);
+  writer.write(declaration.name);
+  writer.write(declaration.isList, 1);
+  writer.write(declaration.values.size(), 4);
+  for (const ModuleInterface::Value& value : declaration.values) {
+    writer.write(static_cast<uint64_t>(value.type), 2);
+    writer.write(value.lexeme);
+  }
+}
+
+static ModuleInterface::Declaration ReadDeclaration(InterfaceReader& reader) {
+  ModuleInterface::Declaration declaration;
+  declaration.isConstant = reader.read(1);
+  declaration.type = reader.readString();
+  declaration.isPointer = reader.read(1);
+  declaration.arraySize = reader.read(8);
+  declaration.name = reader.readString();
+  declaration.isList = reader.read(1);
+  for (size_t values = reader.read(4); values > 0 && reader.isValid(); values--) {
+    const enum TokenType type = static_cast<enum TokenType>(reader.read(2));
+    declaration.values.push_back({ type, reader.readString() });
+  }
+  return declaration;
+}
+
+string ModuleInterface::SerializeStructure(const Structure& structure) {
+  InterfaceWriter writer;
+  writer.write(structure.name);
+  writer.write(structure.annotations.size(), 4);
+  for (const auto& [name, argument] : structure.annotations) {
+    writer.write(name);
+    writer.write(argument.has_value(), 1);
+    writer.write(argument.value_or(0), 8);
+  }
+  writer.write(structure.members.size(), 4);
+  for (const Declaration& member : structure.members)
+    WriteDeclaration(writer, member);
+  return writer.getBytes();
+}
+
+string ModuleInterface::serialize() const {
+  InterfaceWriter writer;
+  for (const char character : string_view(MAGIC))
+    writer.write(character, 1);
+  writer.write(VERSION, 4);
+  writer.write(m_key, 8);
+
+  writer.write(m_imports.size(), 4);
+  for (const auto& [path, key] : m_imports) {
+    writer.write(path);
+    writer.write(key, 8);
+  }
+
+  writer.write(m_structures.size(), 4);
+  for (const Structure& structure : m_structures)
+    writer.append(SerializeStructure(structure));
+
+  writer.write(m_constants.size(), 4);
+  for (const Declaration& constant : m_constants)
+    WriteDeclaration(writer, constant);
+
+  writer.write(m_functions.size(), 4);
+  for (const Signature& function : m_functions) {
+    writer.write(function.returnType);
+    writer.write(function.isPointer, 1);
+    writer.write(function.name);
+    writer.write(function.arguments.size(), 4);
+    for (const Argument& argument : function.arguments) {
+      writer.write(argument.type);
+      writer.write(argument.isPointer, 1);
+      writer.write(argument.isRestrict, 1);
+      writer.write(argument.name);
+    }
+  }
+  return writer.getBytes();
+}
+
+bool ModuleInterface::deserialize(const string& bytes) {
+  InterfaceReader reader(bytes);
+  for (const char character : string_view(MAGIC))
+    if (static_cast<char>(reader.read(1)) != character)
+      return false;
+  if (reader.read(4) != VERSION)
+    return false;
+  m_key = reader.read(8);
+
+  for (size_t imports = reader.read(4); imports > 0 && reader.isValid(); imports--) {
+    string path = reader.readString();
+    m_imports.emplace_back(std::move(path), reader.read(8));
+  }
+
+  for (size_t structures = reader.read(4); structures > 0 && reader.isValid(); structures--) {
+    Structure structure{ reader.readString(), {}, {} };
+    for (size_t annotations = reader.read(4); annotations > 0 && reader.isValid(); annotations--) {
+      string name = reader.readString();
+      const bool hasArgument = reader.read(1);
+      const uint64_t argument = reader.read(8);
+      structure.annotations.emplace_back(std::move(name), hasArgument ? optional<uint64_t>(argument) : std::nullopt);
+    }
+    for (size_t members = reader.read(4); members > 0 && reader.isValid(); members--)
+      structure.members.push_back(ReadDeclaration(reader));
+    m_structures.push_back(std::move(structure));
+  }
+
+  for (size_t constants = reader.read(4); constants > 0 && reader.isValid(); constants--)
+    m_constants.push_back(ReadDeclaration(reader));
+
+  for (size_t functions = reader.read(4); functions > 0 && reader.isValid(); functions--) {
+    Signature function;
+    function.returnType = reader.readString();
+    function.isPointer = reader.read(1);
+    function.name = reader.readString();
+    for (size_t arguments = reader.read(4); arguments > 0 && reader.isValid(); arguments--) {
+      Argument argument;
+      argument.type = reader.readString();
+      argument.isPointer = reader.read(1);
+      argument.isRestrict = reader.read(1);
+      argument.name = reader.readString();
+      function.arguments.push_back(std::move(argument));
+    }
+    m_functions.push_back(std::move(function));
+  }
+
+  return reader.isValid() && reader.isAtEnd();
+}
+
+// Written to a temporary file first and renamed, a compiler importing the module at the same
+// time never reads half of it. The temporary file has a unique name, other compilers writing the
+// same interface use their own. Without a writable directory the module is parsed every time
+void ModuleInterface::store() const {
+  const string path = GetInterfacePath(m_path);
+  int descriptor;
+  llvm::SmallString<128> temporary;
+  if (std::error_code code = llvm::sys::fs::createUniqueFile(path + ".tmp%%%%%%%%", descriptor, temporary)) {
+    warning("Couldn't write the interface of " + m_path + " to " + path + ": " + code.message());
+    return;
+  }
+
+  {
+    llvm::raw_fd_ostream file(descriptor, true);
+    file << serialize();
+    file.close();
+    if (file.has_error()) {
+      warning("Couldn't write the interface of " + m_path + " to " + path + ": " + file.error().message());
+      file.clear_error();
+      std::error_code code;
+      fs::remove(temporary.str().str(), code);
+      return;
+    }
+  }
+
+  std::error_code code;
+  fs::rename(temporary.str().str(), path, code);
+  if (code) {
+    warning("Couldn't write the interface of " + m_path + " to " + path + ": " + code.message());
+    fs::remove(temporary.str().str(), code);
+  }
+}
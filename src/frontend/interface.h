@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../includes/token.hpp"
+
+using std::string, std::vector, std::unordered_map;
+using std::shared_ptr, std::optional;
+
+class Parser;
+
+// What a module shows to the ones importing it: the layouts of the structs it declares or imports,
+// the signatures of its #export functions and the values of its constants. It's written next to
+// the source as a .shqi file the first time the module is imported, later imports read it back
+// instead of lexing and parsing the source again, until the source or one of its imports changes
+class ModuleInterface {
+public:
+  static constexpr uint32_t VERSION = 1;
+
+  // Reads the `import "path";` directives at the top of the tokens of the module at path, the
+  // index is left on the first token after them. Paths are relative to the importing module
+  static vector<shared_ptr<const ModuleInterface>> ImportAll(const vector<Token>& tokens, size_t& index, const string& path);
+  static shared_ptr<const ModuleInterface> Import(const string& path);
+
+  // Tokens declaring the module in the importing one. Structs already in structs (name and layout)
+  // aren't declared twice, the same name with another layout is an error. Returns the number of
+  // declarations appended
+  size_t appendDeclarations(vector<Token>& tokens, unordered_map<string, string>& structs) const;
+
+  const string& getPath() const;
+  uint64_t getKey() const;
+
+  // Records the interface is made of, in the order they're written
+  struct Value {
+    enum TokenType type; // type of the literal
+    string lexeme;
+  };
+
+  // Member of a struct or constant, with the literals it's initialized with
+  struct Declaration {
+    bool isConstant = false;
+    string type;
+    bool isPointer = false;
+    uint64_t arraySize = 0;
+    string name;
+    bool isList = false;
+    vector<Value> values;
+  };
+
+  struct Structure {
+    string name;
+    vector<std::pair<string, optional<uint64_t>>> annotations;
+    vector<Declaration> members;
+  };
+
+  struct Argument {
+    string type;
+    bool isPointer = false;
+    bool isRestrict = false;
+    string name;
+  };
+
+  struct Signature {
+    string returnType;
+    bool isPointer = false;
+    string name;
+    vector<Argument> arguments;
+  };
+
+private:
+  string m_path;
+  uint64_t m_key = 0; // hash of the source and of the keys of its imports
+  vector<std::pair<string, uint64_t>> m_imports;
+  vector<Structure> m_structures;
+  vector<Declaration> m_constants;
+  vector<Signature> m_functions;
+
+  static optional<ModuleInterface> Load(const string& path, const uint64_t sourceHash);
+  static ModuleInterface Build(const string& path, const uint64_t sourceHash);
+  static uint64_t GetKey(const uint64_t sourceHash, const vector<std::pair<string, uint64_t>>& imports);
+  static string GetInterfacePath(const string& path);
+
+  void read(const Parser& parser);
+  string serialize() const;
+  bool deserialize(const string& bytes);
+  void store() const;
+
+  static string SerializeStructure(const Structure& structure);
+};
@@ -0,0 +1,332 @@
+#include "interpreter.h"
+
+#include "../includes/ast.h"
+
+optional<Constant> Interpreter::Call(const Function* function, const vector<optional<Constant>>& arguments) {
+  vector<Constant> values;
+  for (const optional<Constant>& argument : arguments) {
+    if (!argument)
+      return std::nullopt;
+    values.push_back(*argument);
+  }
+
+  Interpreter interpreter;
+  return interpreter.call(function, values);
+}
+
+Constant Interpreter::call(const Function* function, const vector<Constant>& arguments) {
+  if (!function->isConstant())
+    fail("it calls " + function->getIdentifier()->toString() + ", only const functions can be evaluated at compile time");
+  if (++m_depth > MAX_DEPTH)
+    fail("the calls are nested more than " + std::to_string(MAX_DEPTH) + " times");
+
+  const size_t callerFrame = m_frame;
+  const Function* caller = m_function;
+  m_frame = m_scopes.size();
+  m_function = function;
+  m_result.reset();
+
+  enterScope();
+  const vector<Parameter*> parameters = function->getParameter();
+  for (size_t index = 0; index < parameters.size(); index++) {
+    const optional<Constant> argument = Constant::Convert(arguments[index], parameters[index]->getType());
+    if (!argument)
+      fail("the argument " + std::to_string(index + 1) + " doesn't fit the type of " + parameters[index]->getIdentifier());
+    m_scopes.back()[parameters[index]->getIdentifier()] = Value{ parameters[index]->getType(), { *argument } };
+    m_memory++;
+  }
+
+  execute(function->getBody());
+  exitScope();
+
+  if (!m_result)
+    fail("it reached the end of the function without returning a value");
+  const Constant result = *m_result;
+
+  m_result.reset();
+  m_function = caller;
+  m_frame = callerFrame;
+  m_depth--;
+  return result;
+}
+
+Interpreter::Flow Interpreter::execute(const vector<ASTNode*>& statements) {
+  enterScope();
+  for (const ASTNode* statement : statements) {
+    const Flow flow = execute(statement);
+    if (flow != Flow::NEXT) {
+      exitScope();
+      return flow;
+    }
+  }
+  exitScope();
+  return Flow::NEXT;
+}
+
+Interpreter::Flow Interpreter::execute(const ASTNode* statement) {
+  step();
+
+  switch (statement->getNodeType()) {
+    case ASTNodeType::VARIABLE:
+      declare(dynamic_cast<const Variable*>(statement));
+      return Flow::NEXT;
+
+    case ASTNodeType::ASSIGNMENT_OPERATOR:
+      assign(dynamic_cast<const AssignmentOperator*>(statement));
+      return Flow::NEXT;
+
+    case ASTNodeType::FUNCTION_CALL:
+      evaluate(statement);
+      return Flow::NEXT;
+
+    // An else if holds the rest of the chain, so only the first else is ever needed
+    case ASTNodeType::IF: {
+      const If* ifStatement = dynamic_cast<const If*>(statement);
+      if (evaluateCondition(ifStatement->getCondition()))
+        return execute(ifStatement->getBody());
+
+      const vector<Else*> elses = ifStatement->getElses();
+      if (elses.empty())
+        return Flow::NEXT;
+      if (const If* elseIf = elses.front()->getIf())
+        return execute(elseIf);
+      return execute(elses.front()->getBody());
+    }
+
+    case ASTNodeType::SWITCH: {
+      const Switch* switchStatement = dynamic_cast<const Switch*>(statement);
+      const Constant value = *Constant::Convert(evaluate(switchStatement->getValue()), switchStatement->getValueType());
+      for (const Case* current : switchStatement->getCases())
+        for (const Constant& label : current->getLabels())
+          if (label.integer == value.integer)
+            return execute(current->getBody());
+
+      if (const Case* fallback = switchStatement->getDefault())
+        return execute(fallback->getBody());
+      return Flow::NEXT;
+    }
+
+    case ASTNodeType::WHILE: {
+      const While* loop = dynamic_cast<const While*>(statement);
+      while (evaluateCondition(loop->getCondition())) {
+        const Flow flow = execute(loop->getBody());
+        if (flow == Flow::RETURN)
+          return flow;
+        if (flow == Flow::BREAK)
+          break;
+      }
+      return Flow::NEXT;
+    }
+
+    case ASTNodeType::DO_WHILE: {
+      const DoWhile* loop = dynamic_cast<const DoWhile*>(statement);
+      do {
+        const Flow flow = execute(loop->getBody());
+        if (flow == Flow::RETURN)
+          return flow;
+        if (flow == Flow::BREAK)
+          break;
+      } while (evaluateCondition(loop->getCondition()));
+      return Flow::NEXT;
+    }
+
+    case ASTNodeType::FOR: {
+      const For* loop = dynamic_cast<const For*>(statement);
+      if (loop->isParallel())
+        fail("a parallel for can't be evaluated at compile time");
+
+      enterScope();
+      declare(loop->getInitialization());
+      while (evaluateCondition(loop->getCondition()->getASTNode())) {
+        const Flow flow = execute(loop->getBody());
+        if (flow == Flow::RETURN) {
+          exitScope();
+          return flow;
+        }
+        if (flow == Flow::BREAK)
+          break;
+        assign(loop->getUpdate());
+      }
+      exitScope();
+      return Flow::NEXT;
+    }
+
+    case ASTNodeType::LOOP_CONTROL:
+      return dynamic_cast<const LoopControl*>(statement)->getKeyword() == "break" ? Flow::BREAK : Flow::CONTINUE;
+
+    case ASTNodeType::RETURN: {
+      const optional<Constant> value = Constant::Convert(evaluate(dynamic_cast<const Return*>(statement)->getValue()->getASTNode()), m_function->getType());
+      if (!value)
+        fail("the returned value doesn't fit the return type");
+      m_result = value;
+      return Flow::RETURN;
+    }
+
+    default:
+      fail("it has a statement that can't be evaluated at compile time, only scalars and arrays of scalars can be used");
+  }
+}
+
+Constant Interpreter::evaluate(const ASTNode* expression) {
+  step();
+
+  // Literals and everything folded by the semantic analysis
+  if (const optional<Constant> constant = Constant::Of(expression))
+    return *constant;
+
+  switch (expression->getNodeType()) {
+    case ASTNodeType::IDENTIFIER:
+      return find(dynamic_cast<const Identifier*>(expression)->toString()).elements.front();
+
+    case ASTNodeType::INDEX_OPERATOR: {
+      const IndexOperator* indexOperator = dynamic_cast<const IndexOperator*>(expression);
+      return element(indexOperator->getIdentifier()->toString(), indexOperator->getIndex());
+    }
+
+    case ASTNodeType::CAST: {
+      const Cast* cast = dynamic_cast<const Cast*>(expression);
+      const optional<Constant> value = Constant::Convert(evaluate(cast->getExpression()), cast->getType());
+      if (!value)
+        fail("a cast converts a value that doesn't fit in the target type");
+      return *value;
+    }
+
+    case ASTNodeType::UNARY_OPERATOR: {
+      const UnaryOperator* unaryOperator = dynamic_cast<const UnaryOperator*>(expression);
+      const optional<Constant> value = unaryOperator->getOperator() == TokenType::NOT ? Constant::FoldNot(evaluate(unaryOperator->getRight())) : std::nullopt;
+      if (!value)
+        fail("pointers can't be used at compile time");
+      return *value;
+    }
+
+    case ASTNodeType::BINARY_OPERATOR: {
+      const BinaryOperator* binaryOperator = dynamic_cast<const BinaryOperator*>(expression);
+      const enum TokenType op = binaryOperator->getOperator();
+
+      if (op == TokenType::AND || op == TokenType::OR) {
+        const bool left = evaluateCondition(binaryOperator->getLeft());
+        const bool result = left == (op == TokenType::OR) ? left : evaluateCondition(binaryOperator->getRight());
+        return *Constant::Convert(Constant{ ASTNodeType::LITERAL_INTEGER, result }, ASTNodeType::BOOL);
+      }
+
+      const optional<Constant> value = Constant::FoldBinary(op, evaluate(binaryOperator->getLeft()), evaluate(binaryOperator->getRight()), binaryOperator->getOperandType());
+      if (!value)
+        fail("an operation is undefined, like a division by zero, or uses vectors");
+      return *value;
+    }
+
+    case ASTNodeType::FUNCTION_CALL: {
+      const FunctionCall* functionCall = dynamic_cast<const FunctionCall*>(expression);
+      if (functionCall->isBuiltin())
+        fail("the builtin " + functionCall->getName() + " works on vectors, they can't be used at compile time");
+
+      vector<Constant> arguments;
+      for (const Expression* argument : functionCall->getArguments())
+        arguments.push_back(evaluate(argument->getASTNode()));
+      return call(functionCall->getFunction(), arguments);
+    }
+
+    default:
+      fail("it has an expression that can't be evaluated at compile time, only scalars and arrays of scalars can be used");
+  }
+}
+
+bool Interpreter::evaluateCondition(const ASTNode* condition) {
+  return evaluate(condition).integer != 0;
+}
+
+void Interpreter::declare(const Variable* variable) {
+  const ASTNodeType type = variable->getType();
+  if (variable->getStructure() || !Constant::IsFoldable(type))
+    fail("the variable " + variable->getIdentifier() + " isn't a scalar or an array of scalars");
+
+  const Constant zero = *Constant::Convert(Constant{ ASTNodeType::LITERAL_INTEGER }, type);
+  const uint64_t size = variable->isArray() ? variable->getArraySize() : 1;
+  if (m_memory + size > MAX_MEMORY)
+    fail("it uses more than " + std::to_string(MAX_MEMORY) + " values at the same time");
+
+  // The initializer is evaluated before the variable is visible, like in the codegen
+  Value value{ type, vector<Constant>(size, zero) };
+  const ASTNode* initializer = variable->getValue();
+  if (const ListInitializer* list = dynamic_cast<const ListInitializer*>(initializer)) {
+    const vector<Expression*> elements = list->getList();
+    for (size_t index = 0; index < elements.size(); index++)
+      value.elements[index] = *Constant::Convert(evaluate(elements[index]->getASTNode()), type);
+  }
+  else if (initializer->getNodeType() != ASTNodeType::NOTHING) {
+    const optional<Constant> converted = Constant::Convert(evaluate(initializer), type);
+    if (!converted)
+      fail("the value of " + variable->getIdentifier() + " doesn't fit its type");
+    value.elements.front() = *converted;
+  }
+
+  unordered_map<string, Value>& scope = m_scopes.back();
+  if (scope.count(variable->getIdentifier()))
+    m_memory -= scope[variable->getIdentifier()].elements.size();
+  scope[variable->getIdentifier()] = std::move(value);
+  m_memory += size;
+}
+
+void Interpreter::assign(const AssignmentOperator* statement) {
+  if (statement->isDereference())
+    fail("pointers can't be used at compile time");
+
+  const Constant value = evaluate(statement->getExpression());
+  const string name = statement->getIdentifier()->toString();
+  const ASTNodeType type = find(name).type;
+  Constant& target = statement->isIndexed() ? element(name, statement->getIndex()) : find(name).elements.front();
+
+  enum TokenType op;
+  switch (statement->getOperator()) {
+    case TokenType::ADDITION_ASSIGNMENT:       op = TokenType::ADDITION; break;
+    case TokenType::SUBTRACTION_ASSIGNMENT:    op = TokenType::SUBTRACTION; break;
+    case TokenType::MULTIPLICATION_ASSIGNMENT: op = TokenType::STAR; break;
+    case TokenType::DIVISION_ASSIGNMENT:       op = TokenType::DIVISION; break;
+    case TokenType::MODULUS_ASSIGNMENT:        op = TokenType::MODULUS; break;
+    default:                                   op = TokenType::ASSIGNMENT; break;
+  }
+
+  const optional<Constant> result = op == TokenType::ASSIGNMENT ? Constant::Convert(value, type) : Constant::FoldBinary(op, target, value, type);
+  if (!result)
+    fail("the assignment to " + name + " is undefined, like a division by zero, or the value doesn't fit its type");
+  target = *result;
+}
+
+// Only the variables of the function running are visible, the constants outside of it are
+// already folded by the semantic analysis
+Interpreter::Value& Interpreter::find(const string& name) {
+  for (size_t index = m_scopes.size(); index > m_frame; index--) {
+    auto found = m_scopes[index - 1].find(name);
+    if (found != m_scopes[index - 1].end())
+      return found->second;
+  }
+  fail("it uses " + name + ", only its parameters, its variables and constants known at compile time can be used");
+}
+
+// The index is evaluated first, the reference returned mustn't outlive another evaluation
+Constant& Interpreter::element(const string& name, const ASTNode* index) {
+  const optional<Constant> position = Constant::Convert(evaluate(index), ASTNodeType::INT64);
+  Value& array = find(name);
+  if (!position || position->getSigned() < 0 || position->integer >= array.elements.size())
+    fail("the index of " + name + " is out of bounds, the array has " + std::to_string(array.elements.size()) + " elements");
+  return array.elements[position->integer];
+}
+
+void Interpreter::enterScope() {
+  m_scopes.emplace_back();
+}
+
+void Interpreter::exitScope() {
+  for (const auto& [name, value] : m_scopes.back())
+    m_memory -= value.elements.size();
+  m_scopes.pop_back();
+}
+
+void Interpreter::step() {
+  if (++m_steps > MAX_STEPS)
+    fail("it didn't finish in " + std::to_string(MAX_STEPS) + " steps, call it with arguments that aren't constant to run it at runtime");
+}
+
+void Interpreter::fail(const string& message) const {
+  error("In the compile time evaluation of the const function " + m_function->getIdentifier()->toString() + ": " + message);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "constant.h"
+
+class ASTNode;
+class Function;
+class Variable;
+class AssignmentOperator;
+
+using std::optional, std::string, std::unordered_map, std::vector;
+
+// Runs the body of a const fn over the AST when it's called with arguments known at compile
+// time, the result replaces the call like any other folded expression. Only scalars and
+// arrays of scalars can be used inside, and every evaluation is bounded: going over the
+// steps or the memory limit, or anything undefined at runtime, is a compile error
+class Interpreter {
+public:
+  static constexpr uint64_t MAX_STEPS = 1000000;   // statements and expressions evaluated
+  static constexpr uint64_t MAX_MEMORY = 1 << 20;  // scalars alive at the same time
+  static constexpr unsigned MAX_DEPTH = 256;       // nested const fn calls
+
+  static optional<Constant> Call(const Function* function, const vector<optional<Constant>>& arguments);
+
+private:
+  enum class Flow { NEXT, BREAK, CONTINUE, RETURN };
+
+  struct Value {
+    ASTNodeType type;
+    vector<Constant> elements; // one for scalars
+  };
+
+  // Calls share the limits, the scopes of the function running start at m_frame
+  vector<unordered_map<string, Value>> m_scopes;
+  size_t m_frame = 0;
+  const Function* m_function = nullptr;
+  optional<Constant> m_result;
+  uint64_t m_steps = 0;
+  uint64_t m_memory = 0;
+  unsigned m_depth = 0;
+
+  Interpreter() = default;
+
+  Constant call(const Function* function, const vector<Constant>& arguments);
+  Flow execute(const vector<ASTNode*>& statements);
+  Flow execute(const ASTNode* statement);
+  Constant evaluate(const ASTNode* expression);
+  bool evaluateCondition(const ASTNode* condition);
+  void declare(const Variable* variable);
+  void assign(const AssignmentOperator* statement);
+  Value& find(const string& name);
+  Constant& element(const string& name, const ASTNode* index);
+  void enterScope();
+  void exitScope();
+  void step();
+
+  [[noreturn]] void fail(const string& message) const;
+};
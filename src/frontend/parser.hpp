@@ -1,5 +1,6 @@
 #pragma once
 
+#include <charconv>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -8,46 +9,86 @@
 #include <unordered_set>
 #include <stack>
 #include <optional>
+#include <mutex>
 
 #include "../includes/token.hpp"
 #include "../includes/ast.h"
 #include "../includes/error.hpp"
 #include "scope.h"
+#include "interface.h"
 
 using std::cout;
 using std::vector, std::unordered_map, std::unordered_set, std::stack;
-using std::unique_ptr, std::make_unique;
+using std::unique_ptr, std::make_unique, std::shared_ptr;
 using std::optional;
 
 #undef NULL
 
 class Parser {
 public:
-  Parser(vector<Token> tokens): m_tokens(std::move(tokens)), index(0), m_line(1) {
-    cout << "----- AST Start -----\n";
+  // The scope stays current until the parser is destroyed, the codegen still looks structs up in it.
+  // Imports are relative to the path of the module. Only the declarations are parsed when the
+  // parser builds the interface of an imported module, the bodies are skipped
+  Parser(vector<Token> tokens, const string& path = "", const bool isDeclarationsOnly = false):
+    m_tokens(std::move(tokens)), index(0), m_line(1), m_path(path), m_isDeclarationsOnly(isDeclarationsOnly) {
+    m_importerScope = Scope::setCurrent(&m_scope);
     parse(); 
+
+    std::lock_guard<std::mutex> lock(getOutputMutex());
+    cout << "----- AST Start -----\n";
+    print();
     cout << "\n-------------------\n\n";
   }
 
-  ~Parser(){}
+  // A module imported while its importer is parsed gives the scope back to it
+  ~Parser(){
+    Scope::setCurrent(m_importerScope);
+  }
 
+  // Function bodies are parsed once every function at the top level is declared, so a
+  // function can call the ones defined after it
   void parse() {
+    resolveImports();
+
+    m_areBodiesDeferred = true;
     while (index < m_tokens.size()){
+      if (isConstantCallInitializer())
+        parseConstantBodies();
       unique_ptr<ASTNode> node = getASTNode();
       m_ast.push_back(std::move(node));
     }
-    print();
+    m_areBodiesDeferred = false;
+
+    if (!m_isDeclarationsOnly)
+      parseDeferredBodies();
   }
 
   const vector<unique_ptr<ASTNode>>& getAST() const {
     return std::move(m_ast);
   }
 
+  const vector<shared_ptr<const ModuleInterface>>& getImports() const {
+    return m_imports;
+  }
+
+  // The declarations of the imported modules are the first nodes of the AST
+  size_t getImportedCount() const {
+    return m_importedCount;
+  }
+
 private:
+  Scope m_scope;
   vector<Token> m_tokens;
   vector<unique_ptr<ASTNode>> m_ast;
   size_t index;
   size_t m_line;
+  bool m_areBodiesDeferred = false;
+  vector<std::pair<Function*, size_t>> m_deferredBodies; // function and the index of its '{'
+  const string m_path;
+  const bool m_isDeclarationsOnly;
+  Scope* m_importerScope;
+  vector<shared_ptr<const ModuleInterface>> m_imports;
+  size_t m_importedCount = 0;
 
   const unordered_set<enum TokenType> assignmentOperatorSet = {
     TokenType::ASSIGNMENT,
@@ -99,6 +140,14 @@ private:
     TokenType::STRING,
     TokenType::BOOL,
     TokenType::NOTHING,
+    TokenType::INT32X4,
+    TokenType::INT32X8,
+    TokenType::INT64X2,
+    TokenType::INT64X4,
+    TokenType::FLOAT32X4,
+    TokenType::FLOAT32X8,
+    TokenType::FLOAT64X2,
+    TokenType::FLOAT64X4,
   };
 
   const unordered_set<enum TokenType> literalsMap = {
@@ -109,12 +158,33 @@ private:
     TokenType::LITERAL_BOOLEAN,
   };
 
+  // The imports are replaced by the declarations of the modules before any node is built, the
+  // nodes keep references to their tokens
+  void resolveImports() {
+    m_imports = ModuleInterface::ImportAll(m_tokens, index, m_path);
+    if (m_imports.empty())
+      return;
+
+    vector<Token> tokens;
+    unordered_map<string, string> structs;
+    for (const shared_ptr<const ModuleInterface>& module : m_imports)
+      m_importedCount += module->appendDeclarations(tokens, structs);
+
+    tokens.insert(tokens.end(), std::make_move_iterator(m_tokens.begin() + index), std::make_move_iterator(m_tokens.end()));
+    m_tokens = std::move(tokens);
+    index = 0;
+  }
+
   unique_ptr<ASTNode> getASTNode(const enum TokenType scope = TokenType::NOTHING, const unique_ptr<Type>& returnType = nullptr) {
     const Token& token = nextToken();
 
     switch(token.type){
-      case TokenType::VAR:
       case TokenType::CONSTANT:
+        if (index + 1 < m_tokens.size() && m_tokens[index + 1].type == TokenType::FUNC)
+          return parseFunction(true);
+        return parseVariable();
+
+      case TokenType::VAR:
         return parseVariable();
 
       case TokenType::FUNC:
@@ -128,23 +198,35 @@ private:
         return parseIdentifier({}, false);
 
       case TokenType::IF:
-        return parseIfStatement();
+        return parseIfStatement(scope, returnType);
+
+      case TokenType::SWITCH:
+        return parseSwitchStatement(scope, returnType);
 
       case TokenType::BREAK:
       case TokenType::CONTINUE:
         return parseLoopControl(scope);
 
       case TokenType::WHILE:
-        return parseWhileStatement();
+        return parseWhileStatement(returnType);
 
       case TokenType::DO:
-        return parseDoWhileStatement();
+        return parseDoWhileStatement(returnType);
 
       case TokenType::FOR:
-        return parseForStatement();
+        return parseForStatement(false, returnType);
+
+      case TokenType::PARALLEL:
+        return parseParallelForStatement();
 
       case TokenType::STRUCT:
         return parseStruct();
+
+      case TokenType::ANNOTATION:
+        return parseAnnotated(scope, returnType);
+
+      case TokenType::IMPORT:
+        error("Imports go at the top of the module, before any declaration", m_line);
       
       default:
         error("Token Not handled yet: " + token.lexemes, m_line);
@@ -251,7 +333,7 @@ private:
   }
 
   bool isStructType(const Token& token) const {
-    return Scope::getInstance()->find(token.lexemes, false).type == ASTNodeType::STRUCTURE;
+    return Scope::getCurrent()->find(token.lexemes, false).type == ASTNodeType::STRUCTURE;
   }
 
   unique_ptr<Variable> parseVariable(const bool isMember = false){
@@ -259,11 +341,16 @@ private:
 
     if (!isType(nextToken()))
       error("In variable declaration was expected a type after " + keyword.lexemes + " keyword", m_line);
-    unique_ptr<Type> type = make_unique<Type>(consumeToken(), isNextTokenType(TokenType::STAR) ? true : false);
-                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                             
-    if (type->isPointer()) 
+    const Token& typeToken = consumeToken();
+    const bool isPointer = isNextTokenType(TokenType::STAR);
+    if (isPointer) 
       consumeToken();
 
+    uint64_t arraySize = 0;
+    if (isNextTokenType(TokenType::LBRACKET))
+      arraySize = parseArraySize(typeToken);
+    unique_ptr<Type> type = make_unique<Type>(typeToken, isPointer, arraySize);
+
     if (!isNextTokenType(TokenType::IDENTIFIER))
       error("In variable declaration was expected a identifier after type: " + keyword.lexemes + " " + type->toString(), m_line);
     unique_ptr<Identifier> identifier = make_unique<Identifier>(consumeToken());
@@ -300,12 +387,44 @@ private:
       error(std::string((isMember) ? "In struct" : "In variable") + " declaration was expected a semicolon", m_line);
   }
 
-  unique_ptr<Function> parseFunction(){
+  uint64_t parseArraySize(const Token& typeToken) {
+    consumeToken(); // consumes '['
+
+    if (!isNextTokenType(TokenType::LITERAL_INTEGER) || nextToken().lexemes[0] == '-')
+      error("In array declaration was expected a positive integer literal as size of " + typeToken.lexemes, m_line);
+    const uint64_t size = parseUnsignedLiteral(consumeToken(), "In array declaration the size of " + typeToken.lexemes);
+    if (size == 0)
+      error("In array declaration was expected a positive integer literal as size of " + typeToken.lexemes, m_line);
+
+    if (!isNextTokenType(TokenType::RBRACKET))
+      error("In array declaration was expected a closing bracket after the size", m_line);
+    consumeToken();
+
+    return size;
+  }
+
+  // Literals that don't fit in 64 bits are reported instead of being wrapped around
+  uint64_t parseUnsignedLiteral(const Token& literal, const string& context) {
+    uint64_t value = 0;
+    const char* end = literal.lexemes.data() + literal.lexemes.size();
+    const auto [last, code] = std::from_chars(literal.lexemes.data(), end, value);
+    if (code == std::errc::result_out_of_range)
+      error(context + " " + literal.lexemes + " is out of range, it must fit in 64 bits", m_line);
+    if (code != std::errc() || last != end)
+      error(context + " " + literal.lexemes + " must be a positive integer literal", m_line);
+    return value;
+  }
+
+  unique_ptr<Function> parseFunction(const bool isConstant = false){
+    if (isConstant)
+      consumeToken(); // consumes 'const'
     consumeToken();
 
     if (!isType(nextToken()))
       error("In function declaration was expected a type after func keyword", m_line);
-    unique_ptr<Type> type = make_unique<Type>(consumeToken(), isNextTokenType(TokenType::STAR) ? true : false);
+    // The type token is consumed first, the order arguments are evaluated in isn't specified
+    const Token& typeToken = consumeToken();
+    unique_ptr<Type> type = make_unique<Type>(typeToken, isNextTokenType(TokenType::STAR));
     if (type->isPointer()) 
       consumeToken();
 
@@ -328,32 +447,126 @@ private:
       }
     }
     consumeToken(); //consumes the ')'
-    const vector<unique_ptr<Parameter>>& paramRef = parameters;
-    unique_ptr<Body> body = parseBody(TokenType::FUNC, paramRef, type);
-    
-    return make_unique<Function>(std::move(type), std::move(identifier), std::move(parameters), std::move(body));
+
+    // A declaration without a body calls into a function another module defines
+    unique_ptr<Function> function = make_unique<Function>(std::move(type), std::move(identifier), std::move(parameters), isConstant);
+    if (isNextTokenType(TokenType::SEMICOLON)) {
+      consumeToken();
+      function->setExternal();
+    }
+    else if (m_areBodiesDeferred) {
+      m_deferredBodies.emplace_back(function.get(), index);
+      skipBody(function->getIdentifier()->toString());
+    }
+    else
+      function->setBody(parseBody(TokenType::FUNC, function->getParameter(), function->getReturnType()));
+    return function;
+  }
+
+  void skipBody(const string& name) {
+    if (!isNextTokenType(TokenType::LCURLY))
+      error("Expected open curly bracket for the body", m_line);
+
+    size_t depth = 0;
+    do {
+      if (isAtEnd())
+        error("The body of the function " + name + " was expected to end with a closing curly bracket", m_line);
+      const enum TokenType type = consumeToken().type;
+      if (type == TokenType::LCURLY)
+        depth++;
+      else if (type == TokenType::RCURLY)
+        depth--;
+    } while (depth > 0);
+  }
+
+  // Const fns go first, the calls to them folded in the other bodies run their bodies. Until
+  // they're all parsed nothing is folded, a const fn can call one whose body comes later
+  void parseDeferredBodies() {
+    const size_t end = index;
+
+    FunctionCall::SetFolding(false);
+    for (const bool isConstant : { true, false }) {
+      for (const auto& [function, start] : m_deferredBodies) {
+        if (function->isConstant() != isConstant || function->hasBody())
+          continue;
+        index = start;
+        function->setBody(parseBody(TokenType::FUNC, function->getParameter(), function->getReturnType()));
+      }
+      FunctionCall::SetFolding(true);
+    }
+
+    index = end;
+  }
+
+  // A global initialized with a call to a const fn needs its body to fold the call, so the const
+  // fns declared before it get their bodies first. The other bodies still wait for every declaration
+  bool isConstantCallInitializer() const {
+    size_t current = index;
+    while (current < m_tokens.size() && m_tokens[current].type == TokenType::ANNOTATION) {
+      current++;
+      if (current < m_tokens.size() && m_tokens[current].type == TokenType::LPAREN)
+        while (current < m_tokens.size() && m_tokens[current++].type != TokenType::RPAREN);
+    }
+
+    if (current >= m_tokens.size() || (m_tokens[current].type != TokenType::VAR && m_tokens[current].type != TokenType::CONSTANT))
+      return false;
+    if (current + 1 < m_tokens.size() && m_tokens[current + 1].type == TokenType::FUNC)
+      return false;
+
+    for (; current + 1 < m_tokens.size() && m_tokens[current].type != TokenType::SEMICOLON; current++) {
+      if (m_tokens[current].type != TokenType::IDENTIFIER || m_tokens[current + 1].type != TokenType::LPAREN)
+        continue;
+      for (const auto& [function, start] : m_deferredBodies)
+        if (function->isConstant() && !function->hasBody() && function->getIdentifier()->toString() == m_tokens[current].lexemes)
+          return true;
+    }
+    return false;
+  }
+
+  void parseConstantBodies() {
+    const size_t end = index;
+
+    FunctionCall::SetFolding(false);
+    for (const auto& [function, start] : m_deferredBodies) {
+      if (!function->isConstant() || function->hasBody())
+        continue;
+      index = start;
+      function->setBody(parseBody(TokenType::FUNC, function->getParameter(), function->getReturnType()));
+    }
+    FunctionCall::SetFolding(true);
+
+    index = end;
   }
 
   unique_ptr<Parameter> parseParameter(){
     if (!isType(nextToken()))
       error("In function declaration was expected a type for the parameter", m_line);
-    unique_ptr<Type> type = make_unique<Type>(consumeToken(), isNextTokenType(TokenType::STAR) ? true : false);
+    // The type token is consumed first, the order arguments are evaluated in isn't specified
+    const Token& typeToken = consumeToken();
+    unique_ptr<Type> type = make_unique<Type>(typeToken, isNextTokenType(TokenType::STAR));
     if (type->isPointer()) 
       consumeToken();
 
+    // Like in C the qualifier goes after the star: float64* restrict values
+    const bool isRestrict = isNextTokenType(TokenType::RESTRICT);
+    if (isRestrict)
+      consumeToken();
+
     if (!isNextTokenType(TokenType::IDENTIFIER))
       error("In function declaration was expected a identifer after type for a parameter:" + type->toString(), m_line);
     unique_ptr<Identifier> identifier = make_unique<Identifier>(consumeToken());
 
-    return make_unique<Parameter>(std::move(type), std::move(identifier));
+    return make_unique<Parameter>(std::move(type), std::move(identifier), isRestrict);
   }
 
-  unique_ptr<Body> parseBody(const enum TokenType scope = TokenType::NOTHING, const vector<unique_ptr<Parameter>>& parameters = {}, const unique_ptr<Type>& returnType = nullptr) {
-    Scope::getInstance()->enterScope();
+  // Nested bodies get the return type of the function they're in, a parallel for gets none
+  // since its body is outlined, so a return can't leave it
+  unique_ptr<Body> parseBody(const enum TokenType scope = TokenType::NOTHING, const vector<Parameter*>& parameters = {}, const unique_ptr<Type>& returnType = nullptr) {
+    Scope::getCurrent()->enterScope();
 
     if (!parameters.empty()){
-      for (const auto& parameter: parameters)
-        Scope::getInstance()->declare(parameter->getIdentifier(), Symbol(parameter.get()));
+      for (const Parameter* parameter: parameters)
+        Scope::getCurrent()->declare(parameter->getIdentifier(), Symbol(parameter));
     }
 
     if (!isNextTokenType(TokenType::LCURLY))
@@ -366,7 +579,7 @@ private:
     }
     consumeToken(); // consumes the '}'
 
-    Scope::getInstance()->exitScope();
+    Scope::getCurrent()->exitScope();
     return make_unique<Body>(std::move(statements));
   }
 
@@ -400,7 +613,8 @@ private:
       consumeToken();
     }
     else {
-      if (!isValidExpression(nextToken()) && !isNextTokenType(TokenType::SEMICOLON))
+      // A call can also end an element of a list initializer
+      if (!isValidExpression(nextToken()) && !isNextTokenType(TokenType::SEMICOLON) && !isNextTokenType(TokenType::COMMA) && !isNextTokenType(TokenType::RCURLY))
         error("In function call was expected a semicolon", m_line);
     }
     
@@ -410,6 +624,10 @@ private:
   unique_ptr<Return> parseReturn(const enum TokenType scope, const unique_ptr<Type>& returnType) {
     consumeToken();
 
+    const bool isTail = isNextTokenType(TokenType::TAIL);
+    if (isTail)
+      consumeToken();
+
     if (!isValidExpression(nextToken()))
       error("In return statement was expected an expression");
     unique_ptr<Expression> expression = parseExpression();
@@ -418,10 +636,10 @@ private:
       error("In return statement was expected a semicolon", m_line);
     consumeToken();
 
-    return make_unique<Return>(returnType, std::move(expression), scope);
+    return make_unique<Return>(returnType, std::move(expression), scope, isTail);
   }
 
-  unique_ptr<DotOperator> parseDotOperator(const Token& token, const bool isInsideExpression = false) {
+  unique_ptr<DotOperator> parseDotOperator(const Token& token, const bool isInsideExpression = false, unique_ptr<Expression> index = nullptr) {
     consumeToken(); // consumes '.'
     unique_ptr<Identifier> identifier = make_unique<Identifier>(token);
 
@@ -429,11 +647,11 @@ private:
       error("In dot operator was expected a member after the dot", m_line);
     if (!isInsideExpression){
       unique_ptr<AssignmentOperator> assignment = parseAssignmentOperator(consumeToken(), true);
-      return make_unique<DotOperator>(std::move(identifier), std::move(assignment));
+      return make_unique<DotOperator>(std::move(identifier), std::move(assignment), std::move(index));
     }
     else {
       unique_ptr<Identifier> member = make_unique<Identifier>(consumeToken());
-      return make_unique<DotOperator>(std::move(identifier), std::move(member));
+      return make_unique<DotOperator>(std::move(identifier), std::move(member), std::move(index));
     }
   }
 
@@ -448,6 +666,12 @@ private:
     if (isInsideExpression){
       if (isNextTokenType(TokenType::LPAREN))
         return parseFunctionCall(token.value(), isInsideExpression);
+      else if (isNextTokenType(TokenType::LBRACKET)) {
+        unique_ptr<Expression> index = parseIndex();
+        if (isNextTokenType(TokenType::DOT))
+          return parseDotOperator(token.value(), isInsideExpression, std::move(index));
+        return make_unique<IndexOperator>(make_unique<Identifier>(token.value()), std::move(index));
+      }
       else
         if (isNextTokenType(TokenType::DOT))
             return parseDotOperator(token.value(), isInsideExpression);
@@ -459,11 +683,31 @@ private:
         return parseDotOperator(token.value(), isInsideExpression);
       else if (isNextTokenType(TokenType::LPAREN))
         return parseFunctionCall(token.value(), isInsideExpression);
+      else if (isNextTokenType(TokenType::LBRACKET)){
+        unique_ptr<Expression> index = parseIndex();
+        if (isNextTokenType(TokenType::DOT))
+          return parseDotOperator(token.value(), isInsideExpression, std::move(index));
+        return parseAssignmentOperator(token.value(), false, isDereference, std::move(index));
+      }
       else
         return parseAssignmentOperator(token.value(), false, isDereference);
   }
+
+  unique_ptr<Expression> parseIndex() {
+    consumeToken(); // consumes '['
+
+    if (!isValidExpression(nextToken()))
+      error("In index operator was expected a valid expression after the opening bracket", m_line);
+    unique_ptr<Expression> index = parseExpression(true);
+
+    if (!isNextTokenType(TokenType::RBRACKET))
+      error("In index operator was expected a closing bracket after the index", m_line);
+    consumeToken();
+
+    return index;
+  }
                 
-  unique_ptr<AssignmentOperator> parseAssignmentOperator(const Token& token, const bool isDotOperator = false, const bool isDereference = false) {
+  unique_ptr<AssignmentOperator> parseAssignmentOperator(const Token& token, const bool isDotOperator = false, const bool isDereference = false, unique_ptr<Expression> index = nullptr) {
     unique_ptr<Identifier> identifier = make_unique<Identifier>(token);
 
     if (!isAssigmentOperator(nextToken()))
@@ -478,10 +722,10 @@ private:
       error("In assignment operator was expected a semicolon after the value", m_line);
     consumeToken();
 
-    return make_unique<AssignmentOperator>(std::move(identifier), std::move(op), std::move(value), isDotOperator, isDereference);
+    return make_unique<AssignmentOperator>(std::move(identifier), std::move(op), std::move(value), isDotOperator, isDereference, std::move(index));
   }
 
-  unique_ptr<If> parseIfStatement(){
+  unique_ptr<If> parseIfStatement(const enum TokenType scope, const unique_ptr<Type>& returnType){
     consumeToken();
 
     if (!isNextTokenType(TokenType::LPAREN))
@@ -496,29 +740,80 @@ private:
       error("In if statement declaration was expected a closing parenthesis after the condition", m_line);
     consumeToken();
 
-    unique_ptr<Body> body = parseBody();
+    unique_ptr<Body> body = parseBody(scope, {}, returnType);
 
     vector<unique_ptr<Else>> elses = {};
     while (!isAtEnd() && isNextTokenType(TokenType::ELSE))
-        elses.push_back(parseElseStatement());
+        elses.push_back(parseElseStatement(scope, returnType));
     
 
     return make_unique<If>(std::move(condition), std::move(body), std::move(elses));
   }
 
-  unique_ptr<Else> parseElseStatement(){
+  unique_ptr<Else> parseElseStatement(const enum TokenType scope, const unique_ptr<Type>& returnType){
     consumeToken(); //consumes 'else'
+
+    // else #unlikely if (...)
+    if (isNextTokenType(TokenType::ANNOTATION)){
+      unique_ptr<ASTNode> node = parseAnnotated(scope, returnType);
+      if (node->getNodeType() != ASTNodeType::IF)
+        error("After else was expected an if or a body", m_line);
+      return make_unique<Else>(unique_ptr<If>(dynamic_cast<If*>(node.release())));
+    }
     
     if (isNextTokenType(TokenType::IF)){
-      unique_ptr<If> ifstatement = parseIfStatement();
+      unique_ptr<If> ifstatement = parseIfStatement(scope, returnType);
       return make_unique<Else>(std::move(ifstatement));
     }
     else {
-      unique_ptr<Body> body = parseBody();
+      unique_ptr<Body> body = parseBody(scope, {}, returnType);
       return make_unique<Else>(std::move(body));
     }
   }
 
+  // switch (value) { case 1, 2 { ... } default { ... } }
+  unique_ptr<Switch> parseSwitchStatement(const enum TokenType scope, const unique_ptr<Type>& returnType){
+    consumeToken();
+
+    if (!isNextTokenType(TokenType::LPAREN))
+      error("In switch statement declaration was expected a opening parenthesis before the value", m_line);
+    consumeToken();
+
+    if (!isValidExpression(nextToken()))
+      error("In switch statement declaration was expected a valid expression for the value", m_line);
+    unique_ptr<Expression> value = parseExpression(true);
+
+    if (!isNextTokenType(TokenType::RPAREN))
+      error("In switch statement declaration was expected a closing parenthesis after the value", m_line);
+    consumeToken();
+
+    if (!isNextTokenType(TokenType::LCURLY))
+      error("In switch statement declaration was expected an open curly bracket before the cases", m_line);
+    consumeToken();
+
+    vector<unique_ptr<Case>> cases = {};
+    while (!isNextTokenType(TokenType::RCURLY)) {
+      vector<unique_ptr<Expression>> values = {};
+      if (isNextTokenType(TokenType::DEFAULT))
+        consumeToken();
+      else if (isNextTokenType(TokenType::CASE)) {
+        do {
+          consumeToken(); // consumes 'case' or the ','
+          if (!isValidExpression(nextToken()))
+            error("In switch statement was expected a value after case", m_line);
+          values.push_back(parseExpression(true));
+        } while (isNextTokenType(TokenType::COMMA));
+      }
+      else
+        error("In switch statement was expected case or default, found: " + nextToken().lexemes, m_line);
+
+      cases.push_back(make_unique<Case>(std::move(values), parseBody(scope, {}, returnType)));
+    }
+    consumeToken(); // consumes the '}'
+
+    return make_unique<Switch>(std::move(value), std::move(cases));
+  }
+
   unique_ptr<LoopControl> parseLoopControl(const enum TokenType scope){
     const Token& keyword = consumeToken();
     
@@ -529,7 +824,7 @@ private:
     return make_unique<LoopControl>(keyword, scope);
   }
 
-  unique_ptr<While> parseWhileStatement(){
+  unique_ptr<While> parseWhileStatement(const unique_ptr<Type>& returnType){
     consumeToken();
 
     if (!isNextTokenType(TokenType::LPAREN))
@@ -544,15 +839,15 @@ private:
       error("In while statement declaration was expected a closing parenthesis after the condition", m_line);
     consumeToken();
 
-    unique_ptr<Body> body = parseBody(TokenType::WHILE);
+    unique_ptr<Body> body = parseBody(TokenType::WHILE, {}, returnType);
 
     return make_unique<While>(std::move(condition), std::move(body));
   }
 
-  unique_ptr<DoWhile> parseDoWhileStatement(){
+  unique_ptr<DoWhile> parseDoWhileStatement(const unique_ptr<Type>& returnType){
     consumeToken();
 
-    unique_ptr<Body> body = parseBody(TokenType::DO);
+    unique_ptr<Body> body = parseBody(TokenType::DO, {}, returnType);
     if (!isNextTokenType(TokenType::WHILE))
       error("In do-while statement declaration was expected the while token after the body");
     consumeToken();
@@ -576,7 +871,15 @@ private:
     return make_unique<DoWhile>(std::move(condition), std::move(body));
   }
 
-  unique_ptr<For> parseForStatement(){
+  unique_ptr<For> parseParallelForStatement(){
+    consumeToken(); // consumes 'parallel'
+
+    if (!isNextTokenType(TokenType::FOR))
+      error("Only for loops can be parallel, was expected the for keyword after parallel", m_line);
+    return parseForStatement(true);
+  }
+
+  unique_ptr<For> parseForStatement(const bool isParallel = false, const unique_ptr<Type>& returnType = nullptr){
     consumeToken(); // consumes 'for'
 
     if (!isNextTokenType(TokenType::LPAREN))
@@ -585,6 +888,9 @@ private:
 
     if (!isNextTokenType(TokenType::VAR) && !isNextTokenType(TokenType::CONSTANT))
       error("In for statement declaration was expected a valid initialization", m_line);
+
+    // The induction variable is only visible inside the loop
+    Scope::getCurrent()->enterScope();
     unique_ptr<Variable> initialization = parseVariable();
 
     if (!isValidExpression(nextToken()))
@@ -603,9 +909,46 @@ private:
       error("In for statement declaration was expected a closing renthesis after the update", m_line);
     consumeToken();
 
-    unique_ptr<Body> body = parseBody(TokenType::FOR);
+    unique_ptr<Body> body = isParallel ? parseBody(TokenType::PARALLEL) : parseBody(TokenType::FOR, {}, returnType);
+    Scope::getCurrent()->exitScope();
+
+    return make_unique<For>(std::move(initialization), std::move(condition), std::move(update), std::move(body), isParallel);
+  }
+
+  unique_ptr<ASTNode> parseAnnotated(const enum TokenType scope, const unique_ptr<Type>& returnType) {
+    vector<unique_ptr<Annotation>> annotations = {};
+    while (isNextTokenType(TokenType::ANNOTATION))
+      annotations.push_back(parseAnnotation());
+
+    unique_ptr<ASTNode> node = getASTNode(scope, returnType);
+    Annotated* annotated = dynamic_cast<Annotated*>(node.get());
+    if (!annotated)
+      error("Annotation #" + annotations.front()->getName() + " can't be placed before this statement", m_line);
+
+    for (const unique_ptr<Annotation>& annotation : annotations)
+      annotation->analyzeAnnotation(node.get());
+    annotated->setAnnotations(std::move(annotations));
+
+    return node;
+  }
+
+  unique_ptr<Annotation> parseAnnotation() {
+    const Token& name = consumeToken(); // consumes the annotation
+
+    optional<uint64_t> argument = {};
+    if (isNextTokenType(TokenType::LPAREN)){
+      consumeToken();
+
+      if (!isNextTokenType(TokenType::LITERAL_INTEGER))
+        error("In annotation #" + name.lexemes + " was expected an integer literal as argument", m_line);
+      argument = parseUnsignedLiteral(consumeToken(), "In annotation #" + name.lexemes + " the argument");
+
+      if (!isNextTokenType(TokenType::RPAREN))
+        error("In annotation #" + name.lexemes + " was expected a closing parenthesis after the argument", m_line);
+      consumeToken();
+    }
 
-    return make_unique<For>(std::move(initialization), std::move(condition), std::move(update), std::move(body));
+    return make_unique<Annotation>(name, argument);
   }
 
   unique_ptr<Struct> parseStruct() {
@@ -638,7 +981,7 @@ private:
 
     vector<unique_ptr<Expression>> elements;
     while(!isNextTokenType(TokenType::RCURLY)){
-      elements.push_back(make_unique<Expression>(parseExpression(true), false));
+      elements.push_back(parseExpression(true));
 
       if (isNextTokenType(TokenType::COMMA)){
         consumeToken();
@@ -682,7 +1025,7 @@ private:
     while (!isAtEnd()) {
       if ((!isInsideParenthesis && isNextTokenType(TokenType::SEMICOLON)) || 
           (isInsideParenthesis && parenCount == 0 && 
-          (isNextTokenType(TokenType::COMMA) || isNextTokenType(TokenType::RPAREN) || isNextTokenType(TokenType::RCURLY)))) 
+          (isNextTokenType(TokenType::COMMA) || isNextTokenType(TokenType::RPAREN) || isNextTokenType(TokenType::LCURLY) || isNextTokenType(TokenType::RCURLY) || isNextTokenType(TokenType::RBRACKET)))) 
         break;
 
       const Token& token = nextToken();
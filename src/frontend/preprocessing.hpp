@@ -6,6 +6,10 @@
 #include <fstream>   
 #include <algorithm>
 #include <string_view>
+#include <mutex>
+
+#include "../includes/token.hpp"
+#include "../includes/error.hpp"
 
 using std::cout, std::cerr, std::endl;
 using std::string, std::string_view, std::stringstream, std::ifstream;
@@ -13,11 +17,12 @@ using std::remove_if, std::size_t;
 
 class Preprocessor {
 public:
-  Preprocessor(int argc, char* argv[]) {
-    cout << "----- Preprocessing -----\n\n";
-    
-    preprocess(argc, argv);
+  Preprocessor(const string& path) {
+    preprocess(path);
 
+    std::lock_guard<std::mutex> lock(getOutputMutex());
+    cout << "----- Preprocessing -----\n\n";
+    print();
     cout << "-------------------------\n\n";
   }
 
@@ -28,28 +33,16 @@ public:
 private:  
   string m_src;
 
-  void preprocess(int argc, char* argv[]) {
-    checkSourcePath(argc);
-
-    m_src = getSourceContents(argv[1]);
+  void preprocess(const string& path) {
+    m_src = getSourceContents(path);
     removeComments(m_src);
-
-    print();
   }
 
   void print() const {
     cout << m_src << "\n\n";
   }
 
-  void checkSourcePath(int argc){
-    if (argc != 2){
-      cerr << "You must insert the source code path\n";
-      cerr << "Correct usage is: comp <file.shq>\n";
-      exit(EXIT_FAILURE);
-    }
-  }
-
-  string getSourceContents(char* path){
+  string getSourceContents(const string& path){
     ifstream src(path);
 
     if (!src.is_open()){
@@ -74,11 +67,23 @@ private:
       src.erase(start, end - start);
     }
 
-    for(size_t start = src.find('#'), end; start != string::npos; start = src.find('#')){
+    for(size_t start = src.find('#'), end; start != string::npos; start = src.find('#', start)){
+      if (isAnnotation(src, start)){
+        start++;
+        continue;
+      }
+
       end = src.find('\n', start);
       if (end == string::npos) end = src.size();
 
       src.erase(start, end - start);
     }
   }
+
+  bool isAnnotation(const string& src, const size_t start) const {
+    size_t end = start + 1;
+    while (end < src.size() && (isalnum(src[end]) || src[end] == '_'))
+      end++;
+    return annotationSet.find(src.substr(start + 1, end - start - 1)) != annotationSet.end();
+  }
 };
\ No newline at end of file
@@ -1,16 +1,21 @@
 #include "scope.h"
 
-Scope* Scope::instance = nullptr;
+#include <utility>
+
+thread_local Scope* Scope::current = nullptr;
 
 Scope::Scope(): symbolTable(1), currentScope(0) {
   enterScope();
 }
 
-Scope* Scope::getInstance() {
-  if (!instance) {
-      instance = new Scope();
-  }
-  return instance;
+Scope* Scope::getCurrent() {
+  if (!current)
+    error("Compiler Error: there's no scope, nothing is being parsed on this thread");
+  return current;
+}
+
+Scope* Scope::setCurrent(Scope* scope) {
+  return std::exchange(current, scope);
 }
 
 void Scope::enterScope() {
@@ -34,14 +39,19 @@ bool Scope::isRedeclared(const string& name) const {
 }
 
 bool Scope::isDeclared(const string& name) const {
-  for (size_t i = symbolTable.size() - 1; i >= 0; i--)
+  for (size_t i = symbolTable.size(); i-- > 0;)
       if (symbolTable[i].count(name) > 0) 
           return true;
   return false;
 }
 
+// The constructor enters the scope of the top level
+bool Scope::isGlobalScope() const {
+  return currentScope == 1;
+}
+
 const Symbol& Scope::find(const string& name, const bool quit) const {    
-  for (size_t i = symbolTable.size() - 1; i >= 0; i--) {
+  for (size_t i = symbolTable.size(); i-- > 0;) {
       auto it = symbolTable[i].find(name);
       if (it != symbolTable[i].end())
           return it->second;
@@ -29,20 +29,23 @@ struct Symbol {
   Symbol(const Parameter* parameter): type(ASTNodeType::PARAMETER), symbol(parameter) {}
 };
 
+// Symbols of the file being parsed. Every parser has its own and makes it the current one of the
+// thread the file is parsed on, the nodes analyze themselves against it while they're built
 class Scope {
 public:
-  static Scope* getInstance();
+  Scope();
+  static Scope* getCurrent();
+  static Scope* setCurrent(Scope* scope); // returns the scope it replaces
   void enterScope();
   void exitScope();
   void declare(const string& name, const Symbol& symbol);
   bool isRedeclared(const string& name) const;
   bool isDeclared(const string& name) const;
+  bool isGlobalScope() const;
   const Symbol& find(const string& name, const bool quit = true) const;
 
 private:
-  static Scope* instance;
+  static thread_local Scope* current;
   vector<unordered_map<string, Symbol>> symbolTable;
   size_t currentScope;
-
-  Scope();  // Private constructor
 };
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <iostream>
 #include <cstdint>
+#include <mutex>
 #include <vector>
 #include <string_view>
 #include <unordered_map>
@@ -18,8 +19,11 @@ class Tokenizer{
 public:
   Tokenizer(const string_view source_code):
     m_src(source_code), index(0), line(1) {
-      cout << "----- Tokenizer -----\n\n";
       tokenize(); 
+
+      std::lock_guard<std::mutex> lock(getOutputMutex());
+      cout << "----- Tokenizer -----\n\n";
+      print();
       cout << "\n---------------------\n\n";
     }
 
@@ -48,42 +52,6 @@ private:
     { '.', TokenType::DOT }
   };
 
-  const unordered_map<string_view, enum TokenType> keywordMap = {
-    { "var", TokenType::VAR },
-    { "const", TokenType::CONSTANT },
-    { "int8", TokenType::INT8 },
-    { "int16", TokenType::INT16 },
-    { "int32", TokenType::INT32 },
-    { "int64", TokenType::INT64 },
-    { "int", TokenType::INT },
-    { "uint8", TokenType::UINT8 },
-    { "uint16", TokenType::UINT16 },
-    { "uint32", TokenType::UINT32 },
-    { "uint64", TokenType::UINT64 },
-    { "uint", TokenType::UINT},
-    { "float32", TokenType::FLOAT32 },
-    { "float64", TokenType::FLOAT64 },
-    { "float", TokenType::FLOAT },
-    { "char", TokenType::CHAR },
-    { "string", TokenType::STRING },
-    { "bool", TokenType::BOOL },
-    { "null", TokenType::NOTHING },
-    { "if", TokenType::IF },
-    { "else", TokenType::ELSE },
-    { "do", TokenType::DO },
-    { "while", TokenType::WHILE },
-    { "for", TokenType::FOR },
-    { "break", TokenType::BREAK },
-    { "continue", TokenType::CONTINUE },
-    { "fn", TokenType::FUNC },
-    { "return", TokenType::RETURN },
-    { "struct", TokenType::STRUCT },
-    { "true", TokenType::LITERAL_BOOLEAN },
-    { "false", TokenType::LITERAL_BOOLEAN },
-    { "and", TokenType::AND},
-    { "or", TokenType::OR},
-  };
-
   const unordered_map<char, enum TokenType> singleCharOperatorMap = {
     { '+', TokenType::ADDITION },
     { '-', TokenType::SUBTRACTION },
@@ -99,6 +67,7 @@ private:
   };
 
   const unordered_map<string_view, enum TokenType> doubleCharOperatorMap = {
+    { "&&", TokenType::AND },
     { "||", TokenType::OR },
     { "==", TokenType::EQUALS },
     { "!=", TokenType::NOT_EQUAL },
@@ -127,7 +96,6 @@ private:
       }
       m_tokens.push_back(getToken(current));
     }
-    print();
   }
 
   const Token getToken(const char& current) {
@@ -149,6 +117,9 @@ private:
     else if (isDoubleQuote(current))
       return tokenString(current);
 
+    else if (isAnnotation(current))
+      return tokenAnnotation();
+
     else
       error("Compiler Error: getToken(), couldn't recognize the token starting with: " + std::string(1, current), line);
   }
@@ -192,6 +163,10 @@ private:
     return current == '\"';
   }
 
+  bool isAnnotation(const char& current) const {
+    return current == '#';
+  }
+
   bool isOperator(const char& current) {
     if (singleCharOperatorMap.find(current) != singleCharOperatorMap.end()){
       if (peekNextChar() == '=')
@@ -274,6 +249,14 @@ private:
       return Token(singleCharOperatorMap.at(character), text, line);
   }
 
+  // The preprocessor only keeps the '#' of known annotations
+  Token tokenAnnotation(){
+    const string name = getText(nextChar());
+    if (annotationSet.find(name) == annotationSet.end())
+      invalidToken('#', "Unknown annotation: #" + name);
+    return Token(TokenType::ANNOTATION, name, line);
+  }
+
   Token tokenText(const char& character){
     const string text = getText(character);
     if (keywordMap.find(text) != keywordMap.end())
@@ -36,6 +36,23 @@ enum class ASTNodeType {
   FLOAT64,
   FLOAT64_PTR,
 
+  INT32X4,
+  INT32X4_PTR,
+  INT32X8,
+  INT32X8_PTR,
+  INT64X2,
+  INT64X2_PTR,
+  INT64X4,
+  INT64X4_PTR,
+  FLOAT32X4,
+  FLOAT32X4_PTR,
+  FLOAT32X8,
+  FLOAT32X8_PTR,
+  FLOAT64X2,
+  FLOAT64X2_PTR,
+  FLOAT64X4,
+  FLOAT64X4_PTR,
+
   CHAR,
   STRING,
   BOOL,
@@ -58,8 +75,12 @@ enum class ASTNodeType {
   PARAMETER,
   RETURN,
   STRUCTURE,
+  SWITCH,
+  CASE,
   TYPE,
   VARIABLE,
   WHILE,
-  LIST_INITIALIZER
+  LIST_INITIALIZER,
+  ANNOTATION,
+  INDEX_OPERATOR
 };
\ No newline at end of file
@@ -1,9 +1,11 @@
 #pragma once
 
+#include "nodes/annotation.h"
 #include "nodes/assignment_operator.h"
 #include "nodes/ASTNode.h"
 #include "nodes/binary_operator.h"
 #include "nodes/body.h"
+#include "nodes/case.h"
 #include "nodes/cast.h"
 #include "nodes/dot_operator.h"
 #include "nodes/dowhile.h"
@@ -14,6 +16,7 @@
 #include "nodes/functioncall.h"
 #include "nodes/identifier.h"
 #include "nodes/if.h"
+#include "nodes/index_operator.h"
 #include "nodes/list_initializer.h"
 #include "nodes/literal.h"
 #include "nodes/loopcontrol.h"
@@ -21,6 +24,7 @@
 #include "nodes/parameter.h"
 #include "nodes/return.h"
 #include "nodes/struct.h"
+#include "nodes/switch.h"
 #include "nodes/type.h"
 #include "nodes/unary_operator.h"
 #include "nodes/variable.h"
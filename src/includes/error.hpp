@@ -1,15 +1,29 @@
 #pragma once
 
 #include <iostream>
+#include <mutex>
 #include "../lib/clistyle/clistyle.hpp"
 
 using std::cerr, std::string;
 
+// Source file the diagnostics of this thread are about, only set when several files are compiled
+inline thread_local string diagnosticSourcePath;
+
+// Files compiled on different threads print every stage as a whole, one at a time
+inline std::mutex& getOutputMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+inline string getDiagnosticLocation(const size_t line) {
+  return (diagnosticSourcePath.empty() ? "" : diagnosticSourcePath + " | ") + "Line: " + std::to_string(line);
+}
+
 [[noreturn]] inline void error(const string& message, const size_t line = 0) {
-  cerr << CLIStyle::red << "Line: " << line << " | Error: " << CLIStyle::reset << message << "\n";
+  cerr << CLIStyle::red << getDiagnosticLocation(line) << " | Error: " << CLIStyle::reset << message << "\n";
   exit(EXIT_FAILURE);
 }
 
 inline void warning(const string& message, const size_t line = 0) {
-  cerr << "Line: " << line << " | Warning: " << message << "\n";
+  cerr << getDiagnosticLocation(line) << " | Warning: " << message << "\n";
 }
@@ -9,10 +9,12 @@
 #include <vector>
 #include <iomanip>
 #include <memory>
+#include <optional>
 #include <variant>
 #include <unordered_set>
 
 #include "../../includes/token.hpp"
+#include "../../frontend/constant.h"
 #include "../../frontend/scope.h"
 #include "../ASTNodeType.h"
 
@@ -28,7 +30,12 @@ public:
   virtual void accept(Codegen* generator) const = 0;
   virtual void print(int indentation_level = 0) const = 0;
   ASTNodeType getNodeType() const { return m_type; }
+  const optional<Constant>& getConstant() const { return m_constant; }
+  void setConstant(const optional<Constant>& constant) const { m_constant = constant; }
   
 private:
   ASTNodeType m_type;
+
+  // Filled by the semantic analysis when the value is known at compile time
+  mutable optional<Constant> m_constant;
 };
@@ -0,0 +1,105 @@
+#include "annotation.h"
+#include "ASTNode.h"
+
+#include "../../backend/codegen.h"
+
+Annotation::Annotation(const Token& token, optional<uint64_t> argument): 
+  ASTNode(ASTNodeType::ANNOTATION), m_name(token.lexemes), m_argument(argument) {}
+
+void Annotation::accept(Codegen* generator) const {
+  generator->visit(this);
+}
+
+void Annotation::print(int indentation_level) const {
+  cout << setw(indentation_level) << " " << "Annotation: #" << m_name;
+  if (m_argument)
+    cout << '(' << m_argument.value() << ')';
+  cout << '\n';
+}
+
+string Annotation::getName() const {
+  return m_name;
+}
+
+optional<uint64_t> Annotation::getArgument() const {
+  return m_argument;
+}
+
+void Annotation::analyzeAnnotation(const ASTNode* target) const {
+  const ASTNodeType type = target->getNodeType();
+  const bool isLoop = type == ASTNodeType::WHILE || type == ASTNodeType::DO_WHILE || type == ASTNodeType::FOR;
+
+  if (m_name == "vectorize" || m_name == "unroll") {
+    if (!isLoop)
+      error("Annotation #" + m_name + " can only be placed before a loop");
+    if (m_argument && m_argument.value() == 0)
+      error("Annotation #" + m_name + " expects a positive number");
+  }
+  else if (m_name == "chunk") {
+    const For* loop = dynamic_cast<const For*>(target);
+    if (!loop || !loop->isParallel())
+      error("Annotation #chunk can only be placed before a parallel for");
+    if (!m_argument || m_argument.value() == 0)
+      error("Annotation #chunk expects the number of iterations taken at a time: #chunk(N)");
+  }
+  else if (m_name == "packed" || m_name == "reorder") {
+    if (type != ASTNodeType::STRUCTURE)
+      error("Annotation #" + m_name + " can only be placed before a struct");
+    if (m_argument)
+      error("Annotation #" + m_name + " doesn't take an argument");
+  }
+  else if (m_name == "align") {
+    if (type != ASTNodeType::STRUCTURE)
+      error("Annotation #align can only be placed before a struct");
+    if (!m_argument || m_argument.value() == 0 || m_argument.value() > 4096 || (m_argument.value() & (m_argument.value() - 1)) != 0)
+      error("Annotation #align expects a power of two up to 4096: #align(N)");
+  }
+  else if (m_name == "soa") {
+    const Variable* variable = dynamic_cast<const Variable*>(target);
+    if (!variable || !variable->isArray() || !Type::AreEquals(variable->getType(), ASTNodeType::IDENTIFIER))
+      error("Annotation #soa can only be placed before the declaration of an array of structs");
+    if (m_argument)
+      error("Annotation #soa doesn't take an argument");
+  }
+  else if (m_name == "inline" || m_name == "noinline" || m_name == "hot" || m_name == "cold") {
+    if (type != ASTNodeType::FUNCTION)
+      error("Annotation #" + m_name + " can only be placed before a function");
+    if (m_argument)
+      error("Annotation #" + m_name + " doesn't take an argument");
+  }
+  else if (m_name == "likely" || m_name == "unlikely") {
+    if (type != ASTNodeType::IF)
+      error("Annotation #" + m_name + " can only be placed before an if");
+    if (m_argument)
+      error("Annotation #" + m_name + " doesn't take an argument");
+  }
+  else if (m_name == "export") {
+    const Variable* variable = dynamic_cast<const Variable*>(target);
+    if (type != ASTNodeType::FUNCTION && !(variable && variable->isGlobal()))
+      error("Annotation #export can only be placed before a function or a global variable");
+    if (m_argument)
+      error("Annotation #export doesn't take an argument");
+  }
+  else
+    error("Unknown annotation #" + m_name);
+}
+
+void Annotated::setAnnotations(vector<unique_ptr<Annotation>> annotations) {
+  m_annotations = std::move(annotations);
+}
+
+const vector<unique_ptr<Annotation>>& Annotated::getAnnotations() const {
+  return m_annotations;
+}
+
+const Annotation* Annotated::findAnnotation(const string& name) const {
+  for (const unique_ptr<Annotation>& annotation : m_annotations)
+    if (annotation->getName() == name)
+      return annotation.get();
+  return nullptr;
+}
+
+void Annotated::printAnnotations(int indentation_level) const {
+  for (const unique_ptr<Annotation>& annotation : m_annotations)
+    annotation->print(indentation_level);
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "ASTNode.h"
+
+#include <optional>
+
+using std::optional;
+
+// Source level hint written as `#name` or `#name(N)` right before the statement it applies to
+class Annotation : public ASTNode {
+public:
+  Annotation(const Token& token, optional<uint64_t> argument);
+
+  void accept(Codegen* generator) const override;
+  void print(int indentation_level = 0) const override;
+
+  string getName() const;
+  optional<uint64_t> getArgument() const;
+  void analyzeAnnotation(const ASTNode* target) const;
+
+private:
+  const string m_name;
+  const optional<uint64_t> m_argument;
+};
+
+// Nodes that can be preceded by annotations
+class Annotated {
+public:
+  virtual ~Annotated() = default;
+
+  void setAnnotations(vector<unique_ptr<Annotation>> annotations);
+  const vector<unique_ptr<Annotation>>& getAnnotations() const;
+  const Annotation* findAnnotation(const string& name) const;
+  void printAnnotations(int indentation_level) const;
+
+private:
+  vector<unique_ptr<Annotation>> m_annotations;
+};
@@ -2,14 +2,15 @@
 #include "ASTNode.h"
 #include "expression.h"
 #include "function.h"
+#include "index_operator.h"
 #include "operator.h"
 #include "parameter.h"
 #include "variable.h"
 
 #include "../../backend/codegen.h"
 
-AssignmentOperator::AssignmentOperator(unique_ptr<Identifier> identifier, unique_ptr<Operator> op, unique_ptr<Expression> value, const bool isDotOperator, const bool isDereference):
-  ASTNode(ASTNodeType::ASSIGNMENT_OPERATOR), m_identifier(std::move(identifier)), m_op(std::move(op)), m_value(std::move(value)), m_isDotOperator(isDotOperator), m_isDereference(isDereference) {
+AssignmentOperator::AssignmentOperator(unique_ptr<Identifier> identifier, unique_ptr<Operator> op, unique_ptr<Expression> value, const bool isDotOperator, const bool isDereference, unique_ptr<Expression> index):
+  ASTNode(ASTNodeType::ASSIGNMENT_OPERATOR), m_identifier(std::move(identifier)), m_op(std::move(op)), m_value(std::move(value)), m_isDotOperator(isDotOperator), m_isDereference(isDereference), m_index(std::move(index)) {
     analyzeAssignmentOperator();
 }
 
@@ -20,6 +21,10 @@ void AssignmentOperator::accept(Codegen* generator) const {
 void AssignmentOperator::print(int indentation_level) const {
   cout << '\n' << setw(indentation_level) << " " << "Assignment Operator {\n";
   m_identifier->print(indentation_level + 2);
+  if (m_index) {
+    cout << setw(indentation_level + 2) << " " << "Index: \n";
+    m_index->print(indentation_level + 2);
+  }
   m_op->print(indentation_level + 2);
   m_value->print(indentation_level + 2);
   cout << setw(indentation_level) << " " << "}\n";
@@ -37,19 +42,57 @@ string AssignmentOperator::getOperatorToString() const {
   return m_op->toString();
 }
 
+bool AssignmentOperator::isDereference() const {
+  return m_isDereference;
+}
+
+bool AssignmentOperator::isIndexed() const {
+  return m_index != nullptr;
+}
+
+ASTNode* AssignmentOperator::getIndex() const {
+  return m_index->getASTNode();
+}
+
+ASTNodeType AssignmentOperator::getIndexType() const {
+  return m_index->getType();
+}
+
 ASTNode* AssignmentOperator::getExpression() const {
   return m_value->getASTNode();
 }
 
+ASTNodeType AssignmentOperator::getExpressionType() const {
+  return m_value->getType();
+}
+
+ASTNodeType AssignmentOperator::getIdentifierType() const {
+  return m_identifierType;
+}
+
 void AssignmentOperator::analyzeAssignmentOperator() const {
   if (m_isDotOperator)
     return;
 
-  const Symbol& symbol = Scope::getInstance()->find(m_identifier->toString());
+  const Symbol& symbol = Scope::getCurrent()->find(m_identifier->toString());
   ASTNodeType identifierType, valueType = m_value->getType();
-  
-  if (symbol.type == ASTNodeType::VARIABLE)
+  // A constant pointer can still be written through
+  if (symbol.type == ASTNodeType::VARIABLE && std::get<const Variable*>(symbol.symbol)->isConstant() &&
+      !((m_index || m_isDereference) && std::get<const Variable*>(symbol.symbol)->isPointer()))
+    error("In assignment operator " + m_identifier->toString() + " is a constant, it can't be assigned");
+  if (m_index && m_isDereference)
+    error("In assignment operator " + m_identifier->toString() + " can't be dereferenced and indexed at the same time, ^" + m_identifier->toString() + " is the same as " + m_identifier->toString() + "[0]");
+
+  if (m_index) {
+    identifierType = IndexOperator::analyzeIndex(m_identifier->toString(), m_index.get());
+    if (Type::AreEquals(identifierType, ASTNodeType::IDENTIFIER))
+      error("In assignment operator the elements of the array of structs " + m_identifier->toString() + " can only be assigned member by member: " + m_identifier->toString() + "[index].member");
+  }
+  else if (symbol.type == ASTNodeType::VARIABLE) {
+    if (std::get<const Variable*>(symbol.symbol)->isArray())
+      error("In assignment operator the array " + m_identifier->toString() + " can only be assigned through the index operator");
     identifierType = std::get<const Variable*>(symbol.symbol)->getType();
+  }
   else if (symbol.type == ASTNodeType::FUNCTION)
     identifierType = std::get<const Function*>(symbol.symbol)->getType();
   else if (symbol.type == ASTNodeType::PARAMETER)
@@ -57,9 +100,13 @@ void AssignmentOperator::analyzeAssignmentOperator() const {
   else
     error("Unexpected error while analizing assignment operator"); 
 
-  if (m_isDereference && ((identifierType >= ASTNodeType::INT && identifierType <= ASTNodeType::FLOAT64_PTR) && static_cast<int>(identifierType) % 2 == 0))
-    identifierType = static_cast<ASTNodeType>(static_cast<int>(identifierType) - 1);
+  if (m_isDereference) {
+    if (!Type::IsPointer(identifierType))
+      error("In assignment operator only pointers can be dereferenced, but " + m_identifier->toString() + " isn't one");
+    identifierType = Type::GetPointeeType(identifierType);
+  }
 
-  if (!Type::AreEquals(identifierType, valueType))
+  m_identifierType = identifierType;
+  if (!Type::AreEquals(identifierType, valueType) && !Type::CanSplat(identifierType, valueType))
     error("In assignment operator the type and the value type doesn't match: " + to_string(static_cast<int>(identifierType)) + " " + to_string(static_cast<int>(valueType)));
 }
\ No newline at end of file
@@ -9,7 +9,7 @@ class Expression;
 
 class AssignmentOperator : public ASTNode {
 public:
-  AssignmentOperator(unique_ptr<Identifier> identifier, unique_ptr<Operator> op, unique_ptr<Expression> value, const bool isDotOperator, const bool isDereference);
+  AssignmentOperator(unique_ptr<Identifier> identifier, unique_ptr<Operator> op, unique_ptr<Expression> value, const bool isDotOperator, const bool isDereference, unique_ptr<Expression> index = nullptr);
   
   void accept(Codegen* generator) const override;
   void print(int indentation_level = 0) const override;
@@ -17,7 +17,13 @@ public:
   enum TokenType getOperator() const;
   Identifier* getIdentifier() const;
   ASTNode* getExpression() const;
+  ASTNodeType getExpressionType() const;
+  ASTNodeType getIdentifierType() const;
   string getOperatorToString() const;
+  bool isDereference() const;
+  bool isIndexed() const;
+  ASTNode* getIndex() const;
+  ASTNodeType getIndexType() const;
 
   void analyzeAssignmentOperator() const;
 
@@ -27,4 +33,6 @@ private:
   unique_ptr<Expression> m_value;
   const bool m_isDotOperator;
   const bool m_isDereference;
+  unique_ptr<Expression> m_index; // Only for array elements: identifier[index] = value
+  mutable ASTNodeType m_identifierType = ASTNodeType::NOTHING;
 };
\ No newline at end of file
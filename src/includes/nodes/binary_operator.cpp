@@ -31,18 +31,79 @@ const ASTNode* BinaryOperator::getRight() const {
   return m_right.get();
 }
 
+ASTNodeType BinaryOperator::getLeftType() const {
+  return m_leftType;
+}
+
+ASTNodeType BinaryOperator::getRightType() const {
+  return m_rightType;
+}
+
+ASTNodeType BinaryOperator::getOperandType() const {
+  return m_operandType;
+}
+
 ASTNodeType BinaryOperator::analyzeBinaryOperator(const BinaryOperator* binaryOperator) const {
   binaryOperator->print(0);
 
   const ASTNodeType leftOperand = Expression::analyzeExpression(binaryOperator->getLeft());
   const ASTNodeType rightOperand = Expression::analyzeExpression(binaryOperator->getRight());
 
+  // There's no pointer arithmetic, other elements are reached with the index operator
+  if (Type::IsPointer(leftOperand) || Type::IsPointer(rightOperand))
+    error("Pointers can't be used in binary operators, dereference them or use the index operator");
+
+  // The right operand is only evaluated when the left one doesn't decide the result
+  if (binaryOperator->m_op->isLogicalOperator()) {
+    if (leftOperand != ASTNodeType::BOOL || rightOperand != ASTNodeType::BOOL)
+      error("The operands of " + binaryOperator->m_op->toString() + " must be booleans: "
+        + std::to_string(static_cast<int>(leftOperand)) + " " + std::to_string(static_cast<int>(rightOperand)));
+
+    binaryOperator->m_leftType = ASTNodeType::BOOL;
+    binaryOperator->m_rightType = ASTNodeType::BOOL;
+    binaryOperator->m_operandType = ASTNodeType::BOOL;
+    binaryOperator->setConstant(Constant::FoldLogical(binaryOperator->getOperator(), Constant::Of(binaryOperator->getLeft()), Constant::Of(binaryOperator->getRight())));
+    return ASTNodeType::BOOL;
+  }
+
+  if (Type::IsVector(leftOperand) || Type::IsVector(rightOperand)) {
+    binaryOperator->m_leftType = leftOperand;
+    binaryOperator->m_rightType = rightOperand;
+    binaryOperator->m_operandType = Type::IsVector(leftOperand) ? leftOperand : rightOperand;
+
+    if (leftOperand != rightOperand && !Type::CanSplat(leftOperand, rightOperand) && !Type::CanSplat(rightOperand, leftOperand))
+      error("In expressions a vector operand can only be combined with the same vector type or with a scalar of its element type: "
+        + std::to_string(static_cast<int>(leftOperand)) + " " + std::to_string(static_cast<int>(rightOperand)));
+    if (!binaryOperator->m_op->isMathOperator())
+      error("Vectors only support element-wise arithmetic, use the reduce_* builtins to compare them");
+
+    return binaryOperator->m_operandType;
+  }
+
   if (!Type::AreEquals(leftOperand, rightOperand)) 
     error("In expressions the left and right operand in a binary operator must have the same type: " 
       + std::to_string(static_cast<int>(leftOperand)) + " " + std::to_string(static_cast<int>(rightOperand)));
   
+  // Literals take the type of the other operand, so `x + 1` with a uint8 x stays 8 bits wide
+  const ASTNodeType leftNode = binaryOperator->getLeft()->getNodeType();
+  const ASTNodeType rightNode = binaryOperator->getRight()->getNodeType();
+  const bool isLeftLiteral = leftNode == ASTNodeType::LITERAL_INTEGER || leftNode == ASTNodeType::LITERAL_FLOAT;
+  const bool isRightLiteral = rightNode == ASTNodeType::LITERAL_INTEGER || rightNode == ASTNodeType::LITERAL_FLOAT;
+
+  binaryOperator->m_leftType = leftOperand;
+  binaryOperator->m_rightType = rightOperand;
+  if (isLeftLiteral && !isRightLiteral)
+    binaryOperator->m_operandType = rightOperand;
+  else if (isRightLiteral && !isLeftLiteral)
+    binaryOperator->m_operandType = leftOperand;
+  else
+    binaryOperator->m_operandType = Type::GetCommonType(leftOperand, rightOperand);
+
+  binaryOperator->setConstant(Constant::FoldBinary(binaryOperator->getOperator(), Constant::Of(binaryOperator->getLeft()),
+    Constant::Of(binaryOperator->getRight()), binaryOperator->m_operandType));
+
   if (binaryOperator->m_op->isComparisonOperator())
     return ASTNodeType::BOOL;
 
-  return leftOperand; 
+  return binaryOperator->m_operandType;
 }
@@ -13,6 +13,9 @@ public:
   const ASTNode* getLeft() const;
   enum TokenType getOperator() const;
   const ASTNode* getRight() const;
+  ASTNodeType getLeftType() const;
+  ASTNodeType getRightType() const;
+  ASTNodeType getOperandType() const;
   
   ASTNodeType analyzeBinaryOperator(const BinaryOperator* binaryOperator) const;
 
@@ -20,4 +23,9 @@ private:
   unique_ptr<ASTNode> m_left;
   unique_ptr<Operator> m_op;
   unique_ptr<ASTNode> m_right;
+
+  // Filled by the semantic analysis, the codegen can't query the scope anymore
+  mutable ASTNodeType m_leftType = ASTNodeType::NOTHING;
+  mutable ASTNodeType m_rightType = ASTNodeType::NOTHING;
+  mutable ASTNodeType m_operandType = ASTNodeType::NOTHING;
 };
\ No newline at end of file
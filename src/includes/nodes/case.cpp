@@ -0,0 +1,51 @@
+#include "case.h"
+
+#include "../../backend/codegen.h"
+
+Case::Case(vector<unique_ptr<Expression>> values, unique_ptr<Body> body):
+  ASTNode(ASTNodeType::CASE), m_values(std::move(values)), m_body(std::move(body)) {}
+
+void Case::accept(Codegen* generator) const {
+  generator->visit(this);
+}
+
+void Case::print(int indentation_level) const {
+  cout << '\n' << setw(indentation_level) << " " << (isDefault() ? "Default" : "Case") << " {\n";
+  for (const unique_ptr<Expression>& value : m_values)
+    value->print(indentation_level + 2);
+  m_body->print(indentation_level + 2);
+  cout << setw(indentation_level) << " " << "}\n";
+}
+
+vector<ASTNode*> Case::getValues() const {
+  vector<ASTNode*> values = {};
+  for (const unique_ptr<Expression>& value : m_values)
+    values.push_back(value->getASTNode());
+  return values;
+}
+
+vector<ASTNode*> Case::getBody() const {
+  return m_body->getStatements();
+}
+
+bool Case::isDefault() const {
+  return m_values.empty();
+}
+
+const vector<Constant>& Case::getLabels() const {
+  return m_labels;
+}
+
+// Every value is known at compile time, that's what lets the codegen build a jump table
+void Case::analyzeCase(const ASTNodeType type) const {
+  for (const unique_ptr<Expression>& value : m_values) {
+    if (!Type::AreEquals(type, value->getType()))
+      error("In switch statement the values of a case must have the same type as the value switched on: "
+        + std::to_string(static_cast<int>(value->getType())) + " " + std::to_string(static_cast<int>(type)));
+
+    const optional<Constant> label = Constant::Convert(Constant::Of(value->getASTNode()), type);
+    if (!label)
+      error("In switch statement the values of a case must be known at compile time");
+    m_labels.push_back(label.value());
+  }
+}
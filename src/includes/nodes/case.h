@@ -0,0 +1,27 @@
+#pragma once
+
+#include "ASTNode.h"
+#include "expression.h"
+#include "body.h"
+
+// One arm of a switch, the default one has no values
+class Case: public ASTNode {
+public:
+  Case(vector<unique_ptr<Expression>> values, unique_ptr<Body> body);
+
+  void accept(Codegen* generator) const override;
+  void print(int indentation_level = 0) const override;
+
+  vector<ASTNode*> getValues() const;
+  vector<ASTNode*> getBody() const;
+  bool isDefault() const;
+  const vector<Constant>& getLabels() const;
+  void analyzeCase(const ASTNodeType type) const;
+
+private:
+  vector<unique_ptr<Expression>> m_values;
+  unique_ptr<Body> m_body;
+
+  // Filled by the semantic analysis, the values converted to the type of the switch
+  mutable vector<Constant> m_labels;
+};
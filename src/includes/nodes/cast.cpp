@@ -25,6 +25,24 @@ ASTNode* Cast::getExpression() const {
   return m_expression->getASTNode();
 }
 
+ASTNodeType Cast::getExpressionType() const {
+  return m_expression->getType();
+}
+
+// Casting a scalar to a vector converts it to the element type and broadcasts it,
+// casting between vectors converts every lane and needs the same number of lanes
 ASTNodeType Cast::analyzeCast() const {
-  return m_type->getNodeType();
+  const ASTNodeType type = m_type->getNodeType(), expressionType = m_expression->getType();
+
+  if (Type::IsPointer(expressionType))
+    error("Casting a pointer is not allowed, dereference it to cast the value it points to");
+  if (Type::IsVector(expressionType) && !Type::IsVector(type))
+    error("Casting a vector to the scalar type " + m_type->toString() + " is not allowed, use extract or the reduce_* builtins");
+  if (Type::IsVector(expressionType) && Type::GetLaneCount(expressionType) != Type::GetLaneCount(type))
+    error("Casting between vectors with a different number of lanes is not allowed: " + m_type->toString());
+
+  if (!Type::IsVector(type))
+    setConstant(Constant::Convert(Constant::Of(getExpression()), type));
+
+  return type;
 }
\ No newline at end of file
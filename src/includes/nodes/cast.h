@@ -12,6 +12,7 @@ public:
   void print(int indentation_level = 0) const override;
 
   ASTNode* getExpression() const;
+  ASTNodeType getExpressionType() const;
   ASTNodeType getType() const;
   ASTNodeType analyzeCast() const;
 
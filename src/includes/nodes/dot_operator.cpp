@@ -2,14 +2,19 @@
 #include "ASTNode.h"
 #include "variable.h"
 #include "struct.h"
+#include "index_operator.h"
 
 #include "../../backend/codegen.h"
 
-DotOperator::DotOperator(unique_ptr<Identifier> identifier, unique_ptr<AssignmentOperator> assigment):
-  ASTNode(ASTNodeType::DOT_OPERATOR), m_identifier(std::move(identifier)), m_assigment(std::move(assigment)), m_member(nullptr) {}
+DotOperator::DotOperator(unique_ptr<Identifier> identifier, unique_ptr<AssignmentOperator> assigment, unique_ptr<Expression> index):
+  ASTNode(ASTNodeType::DOT_OPERATOR), m_identifier(std::move(identifier)), m_assigment(std::move(assigment)), m_member(nullptr), m_index(std::move(index)) {
+    analyzeDotOperator();
+}
 
-DotOperator::DotOperator(unique_ptr<Identifier> identifier, unique_ptr<Identifier> member):
-  ASTNode(ASTNodeType::DOT_OPERATOR), m_identifier(std::move(identifier)), m_assigment(nullptr), m_member(std::move(member)) {}
+DotOperator::DotOperator(unique_ptr<Identifier> identifier, unique_ptr<Identifier> member, unique_ptr<Expression> index):
+  ASTNode(ASTNodeType::DOT_OPERATOR), m_identifier(std::move(identifier)), m_assigment(nullptr), m_member(std::move(member)), m_index(std::move(index)) {
+    analyzeDotOperator();
+}
 
 void DotOperator::accept(Codegen* generator) const {
   generator->visit(this);
@@ -18,6 +23,10 @@ void DotOperator::accept(Codegen* generator) const {
 void DotOperator::print(int indentation_level) const {
   cout << '\n' << setw(indentation_level) << " " << "DotOperator: {\n";
   m_identifier->print(indentation_level + 2);
+  if (m_index) {
+    cout << setw(indentation_level + 2) << " " << "Index: \n";
+    m_index->print(indentation_level + 2);
+  }
   if (m_assigment){
     cout << setw(indentation_level + 2) << " " << "Member: " << m_assigment->getIdentifier()->toString() << '\n';
     cout << setw(indentation_level + 2) << " " << "Operator: " << m_assigment->getOperatorToString() << '\n';
@@ -29,8 +38,56 @@ void DotOperator::print(int indentation_level) const {
   cout << setw(indentation_level) << " " << "}\n";  
 }
 
+Identifier* DotOperator::getIdentifier() const {
+  return m_identifier.get();
+}
+
+string DotOperator::getMember() const {
+  return m_assigment ? m_assigment->getIdentifier()->toString() : m_member->toString();
+}
+
+// Only set when the member is assigned: identifier.member = value
+AssignmentOperator* DotOperator::getAssignment() const {
+  return m_assigment.get();
+}
+
+bool DotOperator::isIndexed() const {
+  return m_index != nullptr;
+}
+
+ASTNode* DotOperator::getIndex() const {
+  return m_index->getASTNode();
+}
+
+ASTNodeType DotOperator::getIndexType() const {
+  return m_index->getType();
+}
+
 ASTNodeType DotOperator::getMemberType(const DotOperator* dotOperator) const {
-  const Struct* structure = Struct::getStructure(dotOperator->m_identifier->toString());
-  const size_t index = structure->getMemberIndex(dotOperator->m_member->toString());
-  return structure->getMember(index)->getType();
-}
\ No newline at end of file
+  return dotOperator->m_memberType;
+}
+
+void DotOperator::analyzeDotOperator() const {
+  const string name = m_identifier->toString();
+  if (m_index) {
+    if (!Type::AreEquals(IndexOperator::analyzeIndex(name, m_index.get()), ASTNodeType::IDENTIFIER))
+      error("In dot operator " + name + " isn't an array of structs");
+  }
+  else {
+    const Symbol& symbol = Scope::getCurrent()->find(name);
+    if (symbol.type != ASTNodeType::VARIABLE || std::get<const Variable*>(symbol.symbol)->isArray() ||
+        !Type::AreEquals(std::get<const Variable*>(symbol.symbol)->getType(), ASTNodeType::IDENTIFIER))
+      error("In dot operator " + name + " isn't a struct variable");
+  }
+
+  const Struct* structure = Struct::getStructure(name);
+  m_memberType = structure->getMember(structure->getMemberIndex(getMember()))->getType();
+
+  if (m_assigment) {
+    if (std::get<const Variable*>(Scope::getCurrent()->find(name).symbol)->isConstant())
+      error("In dot operator " + name + " is a constant, its members can't be assigned");
+    const ASTNodeType valueType = m_assigment->getExpressionType();
+    if (!Type::AreEquals(m_memberType, valueType) && !Type::CanSplat(m_memberType, valueType))
+      error("In dot operator the member " + name + "." + getMember() + " and the value type doesn't match");
+  }
+}
@@ -8,18 +8,28 @@ class AssignmentOperator;
 
 class DotOperator: public ASTNode {
 public:
-  DotOperator(unique_ptr<Identifier> identifier, unique_ptr<AssignmentOperator> assigment);
-  DotOperator(unique_ptr<Identifier> identifier, unique_ptr<Identifier> member);
+  DotOperator(unique_ptr<Identifier> identifier, unique_ptr<AssignmentOperator> assigment, unique_ptr<Expression> index = nullptr);
+  DotOperator(unique_ptr<Identifier> identifier, unique_ptr<Identifier> member, unique_ptr<Expression> index = nullptr);
 
   void accept(Codegen* generator) const override;
   void print(int indentation_level = 0) const override;
 
+  Identifier* getIdentifier() const;
+  string getMember() const;
+  AssignmentOperator* getAssignment() const;
+  bool isIndexed() const;
+  ASTNode* getIndex() const;
+  ASTNodeType getIndexType() const;
   ASTNodeType getMemberType(const DotOperator* dotOperator) const;
 
+  void analyzeDotOperator() const;
+
 private:
   unique_ptr<Identifier> m_identifier;
   unique_ptr<AssignmentOperator> m_assigment;
   unique_ptr<Identifier> m_member;
+  unique_ptr<Expression> m_index; // Only for members of array elements: identifier[index].member
+  mutable ASTNodeType m_memberType = ASTNodeType::NOTHING;
 };
 
 
@@ -11,6 +11,7 @@ void DoWhile::accept(Codegen* generator) const {
 
 void DoWhile::print(int indentation_level) const {
   cout << '\n' << setw(indentation_level) << " " << "Do-While Statement{\n";
+  printAnnotations(indentation_level + 2);
   m_condition->print(indentation_level + 2);
   m_body->print(indentation_level + 2);
   cout << setw(indentation_level) << " " << "}\n";
@@ -1,10 +1,11 @@
 #pragma once
 
 #include "ASTNode.h"
+#include "annotation.h"
 #include "expression.h"
 #include "body.h"
 
-class DoWhile : public ASTNode {
+class DoWhile : public ASTNode, public Annotated {
 public:
   DoWhile(unique_ptr<Expression> condition, unique_ptr<Body> body);
 
@@ -21,6 +21,11 @@ void Else::print(int indentation_level) const {
   cout << setw(indentation_level) << " " << "} " << endl;
 }
 
+// Only set for else if, the body belongs to the if then
+const If* Else::getIf() const {
+  return m_ifstatement.get();
+}
+
 vector<ASTNode*> Else::getBody() const {
   return m_body->getStatements();
 }
\ No newline at end of file
@@ -14,6 +14,7 @@ public:
   void print(int indentation_level = 0) const override;
 
   vector<ASTNode*> getBody() const;
+  const If* getIf() const;
 
 private:
   unique_ptr<If> m_ifstatement;
@@ -5,8 +5,10 @@
 
 Expression::Expression(unique_ptr<ASTNode> start, const bool isCondition): 
   ASTNode(start->getNodeType()), m_start(std::move(start)), m_isCondition(isCondition) {
-    if (m_isCondition)
+    if (m_isCondition) {
       Expression::analyzeCondition(m_start.get());
+      m_type = ASTNodeType::BOOL;
+    }
     else 
       m_type = Expression::analyzeExpression(m_start.get());
   }
@@ -70,6 +72,10 @@ ASTNodeType Expression::analyzeExpression(const ASTNode* expression) {
       if (const FunctionCall* functionCall = dynamic_cast<const FunctionCall*>(expression))
         return functionCall->analyzeFunctionCall(functionCall);
       
+    case ASTNodeType::INDEX_OPERATOR:
+      if (const IndexOperator* indexOperator = dynamic_cast<const IndexOperator*>(expression))
+        return indexOperator->analyzeIndexOperator(indexOperator);
+
     case ASTNodeType::DOT_OPERATOR:
       if (const DotOperator* dotOperator = dynamic_cast<const DotOperator*>(expression))
         return dotOperator->getMemberType(dotOperator);
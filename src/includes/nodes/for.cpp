@@ -2,15 +2,19 @@
 
 #include "../../backend/codegen.h"
 
-For::For(unique_ptr<Variable> initialization, unique_ptr<Expression> condition, unique_ptr<AssignmentOperator> update, unique_ptr<Body> body):
-  ASTNode(ASTNodeType::FOR), m_initialization(std::move(initialization)), m_condition(std::move(condition)), m_update(std::move(update)), m_body(std::move(body)) {}
+For::For(unique_ptr<Variable> initialization, unique_ptr<Expression> condition, unique_ptr<AssignmentOperator> update, unique_ptr<Body> body, const bool isParallel):
+  ASTNode(ASTNodeType::FOR), m_initialization(std::move(initialization)), m_condition(std::move(condition)), m_update(std::move(update)), m_body(std::move(body)), m_isParallel(isParallel) {
+    if (m_isParallel)
+      analyzeParallelFor();
+  }
   
 void For::accept(Codegen* generator) const {
   generator->visit(this);
 }
 
 void For::print(int indentation_level) const {
-  cout << '\n' << setw(indentation_level) << " " << "For Statement{\n";
+  cout << '\n' << setw(indentation_level) << " " << (m_isParallel ? "Parallel " : "") << "For Statement{\n";
+  printAnnotations(indentation_level + 2);
   m_initialization->print(indentation_level + 2);
   m_condition->print(indentation_level + 2);
   m_update->print(indentation_level + 2);
@@ -32,4 +36,27 @@ Expression* For::getCondition() const {
 
 vector<ASTNode*> For::getBody() const {
   return m_body->getStatements();
-}
\ No newline at end of file
+}
+bool For::isParallel() const {
+  return m_isParallel;
+}
+
+// Iterations of a parallel for are dealt to the workers before any of them runs, so the
+// trip count must be computable upfront: `i < n` or `i <= n` with `i += step`, step > 0
+void For::analyzeParallelFor() const {
+  const string induction = m_initialization->getIdentifier();
+  if (!Type::AreEquals(m_initialization->getType(), ASTNodeType::INT) || m_initialization->isArray())
+    error("In parallel for the induction variable " + induction + " must be an integer");
+
+  const BinaryOperator* condition = dynamic_cast<const BinaryOperator*>(m_condition->getASTNode());
+  const Identifier* bound = condition ? dynamic_cast<const Identifier*>(condition->getLeft()) : nullptr;
+  if (!bound || bound->toString() != induction || (condition->getOperator() != TokenType::LESS && condition->getOperator() != TokenType::LESS_EQUAL))
+    error("In parallel for the condition must compare the induction variable with its bound: " + induction + " < bound or " + induction + " <= bound");
+
+  if (m_update->getIdentifier()->toString() != induction || m_update->isIndexed() || m_update->getOperator() != TokenType::ADDITION_ASSIGNMENT)
+    error("In parallel for the update must increment the induction variable: " + induction + " += step");
+
+  const optional<Constant> step = Constant::Convert(Constant::Of(m_update->getExpression()), ASTNodeType::INT);
+  if (step && step->getSigned() <= 0)
+    error("In parallel for the step must be positive");
+}
@@ -1,13 +1,14 @@
 #pragma once
 #include "ASTNode.h"
+#include "annotation.h"
 #include "body.h"
 #include "variable.h"
 #include "expression.h"
 #include "assignment_operator.h"
 
-class For: public ASTNode {
+class For: public ASTNode, public Annotated {
 public:
-  For(unique_ptr<Variable> initialization, unique_ptr<Expression> condition, unique_ptr<AssignmentOperator> update, unique_ptr<Body> body);
+  For(unique_ptr<Variable> initialization, unique_ptr<Expression> condition, unique_ptr<AssignmentOperator> update, unique_ptr<Body> body, const bool isParallel = false);
   
   void accept(Codegen* generator) const override;
   void print(int indentation_level = 0) const override;
@@ -16,10 +17,13 @@ public:
   AssignmentOperator* getUpdate() const;
   Expression* getCondition() const;
   vector<ASTNode*> getBody() const;
+  bool isParallel() const;
+  void analyzeParallelFor() const;
 
 private:
   unique_ptr<Variable> m_initialization;
   unique_ptr<Expression> m_condition;
   unique_ptr<AssignmentOperator> m_update;
   unique_ptr<Body> m_body;
+  const bool m_isParallel;
 };
\ No newline at end of file
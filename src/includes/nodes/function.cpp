@@ -4,9 +4,14 @@
 #include <nodes/ASTNode.h>
 #include <nodes/identifier.h>
 
-Function::Function(unique_ptr<Type> type, unique_ptr<Identifier> identifier, vector<unique_ptr<Parameter>> parameters, unique_ptr<Body> body):
-  ASTNode(ASTNodeType::FUNCTION), m_type(std::move(type)), m_identifier(std::move(identifier)), m_parameters(std::move(parameters)), m_body(std::move(body)) {
-    Scope::getInstance()->declare(m_identifier->toString(), Symbol(this));
+// The function is declared before its body is parsed, so the body can call it recursively
+Function::Function(unique_ptr<Type> type, unique_ptr<Identifier> identifier, vector<unique_ptr<Parameter>> parameters, const bool isConstant):
+  ASTNode(ASTNodeType::FUNCTION), m_type(std::move(type)), m_identifier(std::move(identifier)), m_parameters(std::move(parameters)), m_isConstant(isConstant) {
+    if (FunctionCall::IsBuiltin(m_identifier->toString()))
+      error("Function " + m_identifier->toString() + " has the same name of a builtin");
+    if (m_isConstant)
+      analyzeConstantFunction();
+    Scope::getCurrent()->declare(m_identifier->toString(), Symbol(this));
 }
 
 void Function::accept(Codegen* generator) const {
@@ -15,17 +20,28 @@ void Function::accept(Codegen* generator) const {
 
 void Function::print(int indentation_level) const {
   cout << '\n' << setw(indentation_level) << " " << "Function {\n";
+  printAnnotations(indentation_level + 2);
+  if (m_isConstant)
+    cout << setw(indentation_level + 2) << " " << "const\n";
   m_type->print(indentation_level + 2);
   m_identifier->print(indentation_level + 2);
   for(const auto& parameter: m_parameters){
     parameter->print(indentation_level + 2);
   }
-  m_body->print(indentation_level + 2);
+  if (m_isExternal)
+    cout << setw(indentation_level + 2) << " " << "external\n";
+  else if (m_body)
+    m_body->print(indentation_level + 2);
   cout << setw(indentation_level) << " " << "}\n";
 }
 
 ASTNodeType Function::getType() const {
-  return m_type->getNodeType();
+  return m_type->getType();
+}
+
+// Returns keep a reference to it to check their value
+const unique_ptr<Type>& Function::getReturnType() const {
+  return m_type;
 }
 
 const Identifier* Function::getIdentifier() const {
@@ -42,4 +58,38 @@ vector<Parameter*> Function::getParameter() const {
 
 vector<ASTNode*> Function::getBody() const {
   return m_body->getStatements();
+}
+
+void Function::setBody(unique_ptr<Body> body) {
+  m_body = std::move(body);
+}
+
+// False while the body is still being parsed
+bool Function::hasBody() const {
+  return m_body != nullptr;
+}
+
+bool Function::isExternal() const {
+  return m_isExternal;
+}
+
+// A const fn is evaluated by running its body, it can't come from another module
+void Function::setExternal() {
+  if (m_isConstant)
+    error("Const function " + m_identifier->toString() + " must have a body, it's evaluated at compile time");
+  m_isExternal = true;
+}
+
+bool Function::isConstant() const {
+  return m_isConstant;
+}
+
+// The result of a const fn replaces the call, so everything it gets and returns must be a scalar
+void Function::analyzeConstantFunction() const {
+  if (!Constant::IsFoldable(getType()))
+    error("Const function " + m_identifier->toString() + " must return a scalar, it's evaluated at compile time");
+
+  for (const unique_ptr<Parameter>& parameter : m_parameters)
+    if (!Constant::IsFoldable(parameter->getType()))
+      error("Const function " + m_identifier->toString() + " can only have scalar parameters: " + parameter->getIdentifier());
 }
\ No newline at end of file
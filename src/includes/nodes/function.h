@@ -1,25 +1,35 @@
 #pragma once
 
+#include "annotation.h"
 #include "type.h"
 #include "identifier.h"
 #include "parameter.h"
 #include "body.h"
 
-class Function: public ASTNode {
+class Function: public ASTNode, public Annotated {
 public:
-  Function(unique_ptr<Type> type, unique_ptr<Identifier> identifier, vector<unique_ptr<Parameter>> parameters, unique_ptr<Body> body);
+  Function(unique_ptr<Type> type, unique_ptr<Identifier> identifier, vector<unique_ptr<Parameter>> parameters, const bool isConstant = false);
   
   void accept(Codegen* generator) const override;
   void print(int indentation_level = 0) const override;
 
   ASTNodeType getType() const;
+  const unique_ptr<Type>& getReturnType() const;
   const Identifier* getIdentifier() const;
   vector<Parameter*> getParameter() const;
   vector<ASTNode*> getBody() const;
+  void setBody(unique_ptr<Body> body);
+  bool hasBody() const;
+  bool isExternal() const;
+  void setExternal();
+  bool isConstant() const;
+  void analyzeConstantFunction() const;
 
 private:
   unique_ptr<Type> m_type;
   unique_ptr<Identifier> m_identifier;
   vector<unique_ptr<Parameter>> m_parameters;
   unique_ptr<Body> m_body;
+  const bool m_isConstant; // const fn, evaluated at compile time when the arguments are constants
+  bool m_isExternal = false; // declared without a body, another module defines it
 };
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "parameter.h"
 
 #include "../../backend/codegen.h"
+#include "../../frontend/interpreter.h"
 
 FunctionCall::FunctionCall(unique_ptr<Identifier> identifier, vector<unique_ptr<Expression>> arguments, const bool isInsideExpression):
   ASTNode(ASTNodeType::FUNCTION_CALL), m_identifier(std::move(identifier)), m_arguments(std::move(arguments)), m_isInsideExpression(isInsideExpression) {
@@ -27,6 +28,10 @@ void FunctionCall::print(int indentation_level) const {
   cout << setw(indentation_level) << " " << "}\n";
 }
 
+string FunctionCall::getName() const {
+  return m_identifier->toString();
+}
+
 vector<Expression*> FunctionCall::getArguments() const {
   vector<Expression*> arguments = {};
   for(const unique_ptr<Expression>& argument: m_arguments){
@@ -35,16 +40,40 @@ vector<Expression*> FunctionCall::getArguments() const {
   return arguments;
 }
 
+const Function* FunctionCall::getFunction() const {
+  return m_function;
+}
+
+bool FunctionCall::isBuiltin() const {
+  return IsBuiltin(getName());
+}
+
+// Off while the bodies of the const fns are parsed, the ones they call may not be complete yet
+void FunctionCall::SetFolding(const bool isEnabled) {
+  s_isFoldingEnabled = isEnabled;
+}
+
+// Builtins operate on vectors and are lowered inline by the codegen, they can't be redefined
+bool FunctionCall::IsBuiltin(const string& name) {
+  static const unordered_set<string> builtins = {
+    "extract", "shuffle", "reduce_add", "reduce_mul", "reduce_min", "reduce_max"
+  };
+  return builtins.find(name) != builtins.end();
+}
+
 ASTNodeType FunctionCall::analyzeFunctionCall(const FunctionCall* functionCall) const {
   const string name = functionCall->m_identifier->toString();
+  if (functionCall->isBuiltin())
+    return functionCall->analyzeBuiltin();
   
-  if (!Scope::getInstance()->isDeclared(name))
+  if (!Scope::getCurrent()->isDeclared(name))
     error("Function call: " + name + " definition wasn't found");
-  const Symbol& symbol = Scope::getInstance()->find(name);
+  const Symbol& symbol = Scope::getCurrent()->find(name);
 
   if (symbol.type != ASTNodeType::FUNCTION)
     error("Another symbol has the same identifier as the function call you're calling");
   const Function* function = std::get<const Function*>(symbol.symbol);
+  functionCall->m_function = function;
   
   const vector<Expression*> arguments = functionCall->getArguments();
   const vector<Parameter*> parameters = function->getParameter();
@@ -55,6 +84,65 @@ ASTNodeType FunctionCall::analyzeFunctionCall(const FunctionCall* functionCall)
   for(size_t i = 0; i < parameters.size(); i++)
     if (!Type::AreEquals(parameters[i]->getType(), arguments[i]->getType()))
       error("In function call the " + std::to_string(i + 1) + "# arguments doesn't match the paramter");
+
+  // A const fn called with constants is run now, the call is replaced by its result. Recursive
+  // calls are left to the evaluation of the outer call, the body isn't complete yet
+  if (s_isFoldingEnabled && function->isConstant() && function->hasBody() && !functionCall->getConstant()) {
+    vector<optional<Constant>> values;
+    for (const Expression* argument : arguments)
+      values.push_back(Constant::Of(argument->getASTNode()));
+    functionCall->setConstant(Interpreter::Call(function, values));
+  }
   
-  return std::get<const Function*>(symbol.symbol)->getType(); //sometimes this value will get discarded
+  return function->getType(); //sometimes this value will get discarded
+}
+
+// extract(v, lane) returns a single lane, shuffle(a, lanes...) and shuffle(a, b, lanes...)
+// pick lanes from one or two vectors of the same type, reduce_*(v) fold all the lanes
+ASTNodeType FunctionCall::analyzeBuiltin() const {
+  const string name = getName();
+  const vector<Expression*> arguments = getArguments();
+
+  if (arguments.empty() || !Type::IsVector(arguments[0]->getType()))
+    error("Builtin " + name + " expects a vector as first argument");
+  const ASTNodeType vectorType = arguments[0]->getType();
+  const uint64_t lanes = Type::GetLaneCount(vectorType);
+
+  if (name == "extract") {
+    if (arguments.size() != 2)
+      error("Builtin extract expects a vector and a lane: extract(v, lane)");
+    analyzeLane(arguments[1], lanes);
+    return Type::GetElementType(vectorType);
+  }
+
+  if (name == "shuffle") {
+    const bool hasSecondVector = arguments.size() > 1 && Type::IsVector(arguments[1]->getType());
+    if (hasSecondVector && arguments[1]->getType() != vectorType)
+      error("Builtin shuffle expects two vectors of the same type");
+
+    const size_t first = hasSecondVector ? 2 : 1;
+    if (arguments.size() - first != lanes)
+      error("Builtin shuffle expects one lane for every lane of the result: " + std::to_string(lanes));
+    for (size_t index = first; index < arguments.size(); index++)
+      analyzeLane(arguments[index], hasSecondVector ? lanes * 2 : lanes);
+    return vectorType;
+  }
+
+  if (arguments.size() != 1)
+    error("Builtin " + name + " expects only the vector to reduce");
+  return Type::GetElementType(vectorType);
+}
+
+// Lanes are selected at compile time, so they must be integer literals in range
+uint64_t FunctionCall::analyzeLane(const Expression* argument, const uint64_t lanes) const {
+  const Literal* literal = dynamic_cast<const Literal*>(argument->getASTNode());
+  if (!literal || !literal->isInteger() || literal->toString()[0] == '-')
+    error("Builtin " + getName() + " expects the lanes as positive integer literals");
+
+  // A literal too large for 64 bits has no value, it's out of range too
+  const optional<Constant> value = Constant::Of(literal);
+  const uint64_t lane = value ? value->integer : lanes;
+  if (lane >= lanes)
+    error("Builtin " + getName() + " lane " + literal->toString() + " is out of range, there are " + std::to_string(lanes) + " lanes");
+  return lane;
 }
\ No newline at end of file
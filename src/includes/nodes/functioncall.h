@@ -4,6 +4,7 @@
 #include "expression.h"
 
 class Expression;
+class Function;
 
 class FunctionCall: public ASTNode {
 public:
@@ -13,10 +14,20 @@ public:
   void print(int indentation_level = 0) const override;
 
   ASTNodeType analyzeFunctionCall(const FunctionCall* functionCall) const;
+  string getName() const;
   vector<Expression*> getArguments() const;
+  bool isBuiltin() const;
+  const Function* getFunction() const;
+  static bool IsBuiltin(const string& name);
+  static void SetFolding(const bool isEnabled);
   
 private:
   unique_ptr<Identifier> m_identifier;
   vector<unique_ptr<Expression>> m_arguments;
   const bool m_isInsideExpression;
+  mutable const Function* m_function = nullptr; // Filled by the semantic analysis, null for builtins
+  static inline thread_local bool s_isFoldingEnabled = true; // per thread, like the scope of the file being parsed
+
+  ASTNodeType analyzeBuiltin() const;
+  uint64_t analyzeLane(const Expression* argument, const uint64_t lanes) const;
 };
\ No newline at end of file
@@ -23,12 +23,15 @@ string Identifier::toString() const {
 
 ASTNodeType Identifier::getIdentifierType(const Identifier* identifier) const {
   const string name = identifier->m_str;
-  if (!Scope::getInstance()->isDeclared(name))
+  if (!Scope::getCurrent()->isDeclared(name))
     error("Identifier: " + name + " is not declared");
 
-  const Symbol& symbol = Scope::getInstance()->find(name);
+  const Symbol& symbol = Scope::getCurrent()->find(name);
   if (symbol.type == ASTNodeType::VARIABLE){
     const Variable* variable = std::get<const Variable*>(symbol.symbol);
+    if (variable->isArray())
+      error("Array: " + name + " can only be used through the index operator");
+    identifier->setConstant(variable->getConstant());
     return variable->getType();
   }
   else if (symbol.type == ASTNodeType::FUNCTION){
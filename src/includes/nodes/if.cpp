@@ -11,6 +11,7 @@ void If::accept(Codegen* generator) const {
 
 void If::print(int indetation_level) const {
   cout << '\n' << setw(indetation_level) << " " << "If Statement{\n";
+  printAnnotations(indetation_level + 2);
   m_condition->print(indetation_level + 2);
   m_body->print(indetation_level + 2);
   cout << setw(indetation_level) << " " << "}\n";
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "annotation.h"
 #include "expression.h"
 #include "body.h"
 #include "else.h"
@@ -7,7 +8,7 @@
 
 class Else;
 
-class If: public ASTNode {
+class If: public ASTNode, public Annotated {
 public:
   If(unique_ptr<Expression> condition, unique_ptr<Body> body, vector<unique_ptr<Else>> elses);
 
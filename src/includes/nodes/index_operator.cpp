@@ -0,0 +1,76 @@
+#include "index_operator.h"
+#include "ASTNode.h"
+#include "expression.h"
+#include "literal.h"
+#include "parameter.h"
+#include "variable.h"
+
+#include "../../backend/codegen.h"
+
+IndexOperator::IndexOperator(unique_ptr<Identifier> identifier, unique_ptr<Expression> index):
+  ASTNode(ASTNodeType::INDEX_OPERATOR), m_identifier(std::move(identifier)), m_index(std::move(index)) {}
+
+void IndexOperator::accept(Codegen* generator) const {
+  generator->visit(this);
+}
+
+void IndexOperator::print(int indentation_level) const {
+  cout << setw(indentation_level) << " " << "Index Operator{\n";
+  m_identifier->print(indentation_level + 2);
+  cout << setw(indentation_level + 2) << " " << "Index: \n";
+  m_index->print(indentation_level + 2);
+  cout << setw(indentation_level) << " " << "}\n";
+}
+
+const Identifier* IndexOperator::getIdentifier() const {
+  return m_identifier.get();
+}
+
+ASTNode* IndexOperator::getIndex() const {
+  return m_index->getASTNode();
+}
+
+ASTNodeType IndexOperator::getIndexType() const {
+  return m_index->getType();
+}
+
+ASTNodeType IndexOperator::analyzeIndexOperator(const IndexOperator* indexOperator) const {
+  const string name = indexOperator->m_identifier->toString();
+  const ASTNodeType elementType = analyzeIndex(name, indexOperator->m_index.get());
+  if (Type::AreEquals(elementType, ASTNodeType::IDENTIFIER))
+    error("The elements of the array of structs " + name + " can only be used member by member: " + name + "[index].member");
+  return elementType;
+}
+
+// Shared with the assignment operator, returns the element type
+ASTNodeType IndexOperator::analyzeIndex(const string& name, const Expression* index) {
+  if (!Scope::getCurrent()->isDeclared(name))
+    error("Identifier: " + name + " is not declared");
+
+  const ASTNodeType indexType = index->getType();
+  if (!Type::AreEquals(indexType, ASTNodeType::INT))
+    error("In index operator on " + name + " the index must be an integer");
+
+  // Pointers are indexed like in C, with no bounds to check
+  const Symbol& symbol = Scope::getCurrent()->find(name);
+  const ASTNodeType type = symbol.type == ASTNodeType::VARIABLE ? std::get<const Variable*>(symbol.symbol)->getType()
+    : symbol.type == ASTNodeType::PARAMETER ? std::get<const Parameter*>(symbol.symbol)->getType() : ASTNodeType::NOTHING;
+  const bool isArray = symbol.type == ASTNodeType::VARIABLE && std::get<const Variable*>(symbol.symbol)->isArray();
+  if (!isArray && Type::IsPointer(type))
+    return Type::GetPointeeType(type);
+
+  if (!isArray)
+    error("Index operator can only be used on arrays and pointers, but " + name + " isn't one");
+  const Variable* array = std::get<const Variable*>(symbol.symbol);
+
+  // Out of range constants are caught here, every other index is checked at runtime
+  // A literal too large for 64 bits has no value, it's out of bounds too
+  const Literal* literal = dynamic_cast<const Literal*>(index->getASTNode());
+  if (literal && literal->isInteger()) {
+    const optional<Constant> value = Constant::Of(literal);
+    if (!value || value->integer >= array->getArraySize())
+      error("In index operator on " + name + " the index " + literal->toString() + " is out of bounds, the array has " + std::to_string(array->getArraySize()) + " elements");
+  }
+
+  return array->getType();
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "ASTNode.h"
+#include "identifier.h"
+#include "expression.h"
+
+class Expression;
+
+// Element access of a fixed size array or through a pointer: identifier[index]
+class IndexOperator: public ASTNode {
+public:
+  IndexOperator(unique_ptr<Identifier> identifier, unique_ptr<Expression> index);
+
+  void accept(Codegen* generator) const override;
+  void print(int indentation_level = 0) const override;
+
+  const Identifier* getIdentifier() const;
+  ASTNode* getIndex() const;
+  ASTNodeType getIndexType() const;
+
+  ASTNodeType analyzeIndexOperator(const IndexOperator* indexOperator) const;
+  static ASTNodeType analyzeIndex(const string& name, const Expression* index);
+
+private:
+  unique_ptr<Identifier> m_identifier;
+  unique_ptr<Expression> m_index;
+};
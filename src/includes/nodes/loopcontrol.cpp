@@ -28,6 +28,8 @@ enum TokenType LoopControl::getScope() const {
 }
 
 void LoopControl::analyzeLoopControl() const {
-  if (m_scope == TokenType::NOTHING)
-    error(m_str + " statement can't be outside a function scope");
+  if (m_scope == TokenType::NOTHING || m_scope == TokenType::FUNC)
+    error(m_str + " statement must be inside a loop");
+  if (m_scope == TokenType::PARALLEL && m_str == "break")
+    error("break statement can't leave a parallel for, every iteration always runs");
 }
\ No newline at end of file
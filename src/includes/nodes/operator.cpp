@@ -24,4 +24,12 @@ string Operator::toString() const {
 
 bool Operator::isComparisonOperator() const {
   return op >= TokenType::OPERATOR_COMPARISON_BEGIN && op <= TokenType::OPERATOR_COMPARISON_END;
+}
+
+bool Operator::isMathOperator() const {
+  return op >= TokenType::OPERATOR_MATH_BEGIN && op <= TokenType::OPERATOR_MATH_END;
+}
+
+bool Operator::isLogicalOperator() const {
+  return op == TokenType::AND || op == TokenType::OR;
 }
\ No newline at end of file
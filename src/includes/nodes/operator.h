@@ -11,6 +11,8 @@ public:
   enum TokenType getOperator() const;
   string toString() const;
   bool isComparisonOperator() const;
+  bool isMathOperator() const;
+  bool isLogicalOperator() const;
 
 private:
   const enum TokenType op;
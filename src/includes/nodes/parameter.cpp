@@ -3,8 +3,11 @@
 
 #include "../../backend/codegen.h"
 
-Parameter::Parameter(unique_ptr<Type> type, unique_ptr<Identifier> name): 
-  ASTNode(ASTNodeType::PARAMETER), m_type(std::move(type)), m_identifier(std::move(name)) {}
+Parameter::Parameter(unique_ptr<Type> type, unique_ptr<Identifier> name, const bool isRestrict):
+  ASTNode(ASTNodeType::PARAMETER), m_type(std::move(type)), m_identifier(std::move(name)), m_isRestrict(isRestrict) {
+    if (m_isRestrict && !m_type->isPointer())
+      error("Only pointer parameters can be restrict, but " + m_identifier->toString() + " isn't one");
+  }
 
 void Parameter::accept(Codegen* generator) const {
   generator->visit(this);
@@ -13,6 +16,8 @@ void Parameter::accept(Codegen* generator) const {
 void Parameter::print(int indentation_level) const {
   cout << '\n' << setw(indentation_level) << " " << "Parameter {\n";
   m_type->print(indentation_level + 2);
+  if (m_isRestrict)
+    cout << setw(indentation_level + 2) << " " << "restrict\n";
   m_identifier->print(indentation_level + 2);
   cout << setw(indentation_level) << " " << "}\n";
 }
@@ -27,4 +32,8 @@ string Parameter::getTypeToString() const {
 
 string Parameter::getIdentifier() const {
   return m_identifier->toString();
-}
\ No newline at end of file
+}
+
+bool Parameter::isRestrict() const {
+  return m_isRestrict;
+}
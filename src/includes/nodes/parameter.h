@@ -6,7 +6,7 @@
 
 class Parameter : public ASTNode {
 public:
-  Parameter(unique_ptr<Type> type, unique_ptr<Identifier> name);
+  Parameter(unique_ptr<Type> type, unique_ptr<Identifier> name, const bool isRestrict = false);
 
   void accept(Codegen* generator) const override;
   void print(int indentation_level = 0) const override;
@@ -14,8 +14,10 @@ public:
   string getIdentifier() const;
   ASTNodeType getType() const;
   string getTypeToString() const;
+  bool isRestrict() const;
 
 private:
   unique_ptr<Type> m_type;
   unique_ptr<Identifier> m_identifier;
+  const bool m_isRestrict; // the memory it points to is only reached through it while the function runs
 };
\ No newline at end of file
@@ -1,13 +1,15 @@
 #include "return.h"
 #include "ASTNode.h"
 #include "expression.h"
+#include "function.h"
+#include "functioncall.h"
 
 #include "../../backend/codegen.h"
 #include <nodes/type.h>
 #include <token.hpp>
 
-Return::Return(const unique_ptr<Type>& type, unique_ptr<Expression> expression, const enum TokenType scope):
-  ASTNode(ASTNodeType::RETURN), type(type), m_expression(std::move(expression)), m_scope(scope) {
+Return::Return(const unique_ptr<Type>& type, unique_ptr<Expression> expression, const enum TokenType scope, const bool isTail):
+  ASTNode(ASTNodeType::RETURN), type(type), m_expression(std::move(expression)), m_scope(scope), m_isTail(isTail) {
     analyzeReturn();
   }
 
@@ -17,6 +19,8 @@ void Return::accept(Codegen* generator) const {
 
 void Return::print(int indentation_level) const {
   cout << '\n' << setw(indentation_level) << " " << "Return {\n";
+  if (m_isTail)
+    cout << setw(indentation_level + 2) << " " << "tail\n";
   m_expression->print(indentation_level + 2);
   cout << setw(indentation_level) << " " << "}\n"; 
 }
@@ -29,13 +33,24 @@ enum TokenType Return::getScope() const {
   return m_scope;
 }
 
+bool Return::isTail() const {
+  return m_isTail;
+}
+
 void Return::analyzeReturn() const {
-  if (m_scope != TokenType::FUNC){
-    error("Return statement can't be outside a function scope");
-    return;
-  }
+  // Only the bodies inside a function get its return type, the one of a parallel for is outlined
+  if (!type)
+    error("Return statement can't be outside a function scope or inside a parallel for");
 
   if (!Type::AreEquals(type->getType(), m_expression->getType()))
     error("Return statement value type and return type doesn't match");
-  
+
+  // The callee returns straight to the caller of this function, nothing can be done with its value
+  if (m_isTail) {
+    const FunctionCall* call = dynamic_cast<const FunctionCall*>(m_expression->getASTNode());
+    if (!call || call->isBuiltin())
+      error("Return tail expects a call to a function: return tail f(...)");
+    if (call->getFunction()->getType() != type->getType())
+      error("Return tail expects " + call->getName() + " to have the same return type as the function it's called from");
+  }
 }
\ No newline at end of file
@@ -6,17 +6,19 @@
 
 class Return: public ASTNode {
 public:
-  Return(const unique_ptr<Type>& type, unique_ptr<Expression> expression, const enum TokenType scope);
+  Return(const unique_ptr<Type>& type, unique_ptr<Expression> expression, const enum TokenType scope, const bool isTail = false);
 
   void accept(Codegen* generator) const override;
   void print(int indentation_level = 0) const override;
 
   Expression* getValue() const;
   enum TokenType getScope() const;
+  bool isTail() const;
   void analyzeReturn() const;
 
 private:
   const unique_ptr<Type>& type;
   unique_ptr<Expression> m_expression;
   const enum TokenType m_scope;
+  const bool m_isTail; // return tail f(...), the call must reuse the frame of the caller
 };
\ No newline at end of file
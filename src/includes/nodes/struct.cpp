@@ -15,6 +15,7 @@ void Struct::accept(Codegen* generator) const {
 
 void Struct::print(int indentation_level) const {
   cout << '\n' << setw(indentation_level) << " " << "Struct {\n";
+  printAnnotations(indentation_level + 2);
   m_identifier->print(indentation_level + 2);
   cout << setw(indentation_level + 2) << " " << "Body: {\n";
   for(const unique_ptr<Variable>& member: m_members){
@@ -24,6 +25,10 @@ void Struct::print(int indentation_level) const {
   cout << setw(indentation_level) << " " << "}\n";
 }
 
+string Struct::getIdentifier() const {
+  return m_identifier->toString();
+}
+
 vector<Variable*> Struct::getMembers() const {
   vector<Variable*> members;
   for(const unique_ptr<Variable>& member: m_members){
@@ -49,11 +54,19 @@ const Variable* Struct::getMember(const size_t index) const {
 }
 
 const Struct* Struct::getStructure(const string& identifer) {
-  const Symbol& variable = Scope::getInstance()->find(identifer);
-  const Symbol& structSymbol = Scope::getInstance()->find(std::get<const Variable*>(variable.symbol)->getTypeToString());
+  const Symbol& variable = Scope::getCurrent()->find(identifer);
+  const Symbol& structSymbol = Scope::getCurrent()->find(std::get<const Variable*>(variable.symbol)->getTypeToString());
   return std::get<const Struct*>(structSymbol.symbol);
 }
 
 void Struct::analyzeStruct() const {
-  Scope::getInstance()->declare(m_identifier->toString(), Symbol(this));
+  for (size_t index = 0; index < m_members.size(); index++) {
+    const Variable* member = m_members[index].get();
+    if (member->isArray() || member->isPointer() || Type::AreEquals(member->getType(), ASTNodeType::IDENTIFIER))
+      error("In struct " + m_identifier->toString() + " the member " + member->getIdentifier() + " must be a scalar or a vector");
+    if (getMemberIndex(member->getIdentifier()) != index)
+      error("In struct " + m_identifier->toString() + " the member " + member->getIdentifier() + " is declared twice");
+  }
+
+  Scope::getCurrent()->declare(m_identifier->toString(), Symbol(this));
 } 
\ No newline at end of file
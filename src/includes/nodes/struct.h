@@ -1,17 +1,19 @@
 #pragma once
 
 #include "ASTNode.h"
+#include "annotation.h"
 #include "expression.h"
 #include "identifier.h"
 #include "variable.h"
 
-class Struct: public ASTNode {
+class Struct: public ASTNode, public Annotated {
 public:
   Struct(unique_ptr<Identifier> identifier, vector<unique_ptr<Variable>> members);
 
   void accept(Codegen* generator) const override;
   void print(int indentation_level = 0) const override;
 
+  string getIdentifier() const;
   vector<Variable*> getMembers() const;
   size_t getMembersSize() const;
   size_t getMemberIndex(const string& identifier) const; 
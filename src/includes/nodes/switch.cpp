@@ -0,0 +1,64 @@
+#include "switch.h"
+
+#include <unordered_set>
+
+#include "../../backend/codegen.h"
+
+Switch::Switch(unique_ptr<Expression> value, vector<unique_ptr<Case>> cases):
+  ASTNode(ASTNodeType::SWITCH), m_value(std::move(value)), m_cases(std::move(cases)) {
+    analyzeSwitch();
+  }
+
+void Switch::accept(Codegen* generator) const {
+  generator->visit(this);
+}
+
+void Switch::print(int indentation_level) const {
+  cout << '\n' << setw(indentation_level) << " " << "Switch Statement{\n";
+  m_value->print(indentation_level + 2);
+  for (const unique_ptr<Case>& current : m_cases)
+    current->print(indentation_level + 2);
+  cout << setw(indentation_level) << " " << "}\n";
+}
+
+ASTNode* Switch::getValue() const {
+  return m_value->getASTNode();
+}
+
+ASTNodeType Switch::getValueType() const {
+  return m_value->getType();
+}
+
+vector<Case*> Switch::getCases() const {
+  vector<Case*> cases = {};
+  for (const unique_ptr<Case>& current : m_cases)
+    cases.push_back(current.get());
+  return cases;
+}
+
+// Null when no case is the default one, then nothing runs for the other values
+const Case* Switch::getDefault() const {
+  for (const unique_ptr<Case>& current : m_cases)
+    if (current->isDefault())
+      return current.get();
+  return nullptr;
+}
+
+void Switch::analyzeSwitch() const {
+  const ASTNodeType type = getValueType();
+  if (Type::GetBitWidth(type) <= 1 || Constant{ type }.isFloat())
+    error("In switch statement the value switched on must be an integer or a char: " + std::to_string(static_cast<int>(type)));
+
+  std::unordered_set<uint64_t> labels;
+  size_t defaults = 0;
+  for (const unique_ptr<Case>& current : m_cases) {
+    defaults += current->isDefault();
+    current->analyzeCase(type);
+    for (const Constant& label : current->getLabels())
+      if (!labels.insert(label.integer).second)
+        error("In switch statement the value " + std::to_string(Type::IsUnsigned(type) ? label.integer : label.getSigned()) + " is used by more than one case");
+  }
+
+  if (defaults > 1)
+    error("In switch statement there can only be one default case");
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "ASTNode.h"
+#include "case.h"
+#include "expression.h"
+
+// Arms don't fall through to the next one, break and continue belong to the enclosing loop
+class Switch: public ASTNode {
+public:
+  Switch(unique_ptr<Expression> value, vector<unique_ptr<Case>> cases);
+
+  void accept(Codegen* generator) const override;
+  void print(int indentation_level = 0) const override;
+
+  ASTNode* getValue() const;
+  ASTNodeType getValueType() const;
+  vector<Case*> getCases() const;
+  const Case* getDefault() const;
+  void analyzeSwitch() const;
+
+private:
+  unique_ptr<Expression> m_value;
+  vector<unique_ptr<Case>> m_cases;
+};
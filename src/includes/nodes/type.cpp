@@ -2,19 +2,25 @@
 
 #include "../../backend/codegen.h"
 
-Type::Type(const Token& token, const bool isPointer): 
-  ASTNode(Type::TokenTypeToASTNodeType(token.type)), m_type(token.type), m_str(token.lexemes), m_isPointer(isPointer) {}
+Type::Type(const Token& token, const bool isPointer, const uint64_t arraySize): 
+  ASTNode(Type::TokenTypeToASTNodeType(token.type)), m_type(token.type), m_str(token.lexemes), m_isPointer(isPointer), m_arraySize(arraySize) {
+    if (m_isPointer && !CanPointTo(getNodeType()))
+      error("Pointers can only point to integers, floats and vectors, not to " + m_str);
+  }
 
 void Type::accept(Codegen* generator) const {
   generator->visit(this);
 }
 
 void Type::print(int indentation_level) const {
-  cout << setw(indentation_level) << " " << "Type: " << m_str << '\n';
+  cout << setw(indentation_level) << " " << "Type: " << m_str;
+  if (isArray())
+    cout << '[' << m_arraySize << ']';
+  cout << '\n';
 }
 
 ASTNodeType Type::getType() const {
-  return isPointer() ? static_cast<ASTNodeType>(static_cast<int>(getNodeType()) + 1) : getNodeType();
+  return isPointer() ? GetPointerType(getNodeType()) : getNodeType();
 }
 
 bool Type::isInteger() const {
@@ -49,6 +55,18 @@ bool Type::isStruct() const {
   return m_type == TokenType::IDENTIFIER;
 }
 
+bool Type::isArray() const {
+  return m_arraySize != 0;
+}
+
+bool Type::isVector() const {
+  return m_type >= TokenType::VECTORS_BEGIN && m_type <= TokenType::VECTORS_END;
+}
+
+uint64_t Type::getArraySize() const {
+  return m_arraySize;
+}
+
 bool Type::AreEquals(const ASTNodeType type, const ASTNodeType valueType) {
   if (type == valueType)
     return true;
@@ -67,6 +85,139 @@ bool Type::AreEquals(const ASTNodeType type, const ASTNodeType valueType) {
          ((floatTypes.find(type) != floatTypes.end()) && (floatTypes.find(valueType) != floatTypes.end()));
 }
 
+// Chars and bools are stored as unsigned bytes/bits, so they're never sign extended
+bool Type::IsUnsigned(const ASTNodeType type) {
+  switch (type) {
+    case ASTNodeType::UINT:
+    case ASTNodeType::UINT8:
+    case ASTNodeType::UINT16:
+    case ASTNodeType::UINT32:
+    case ASTNodeType::UINT64:
+    case ASTNodeType::CHAR:
+    case ASTNodeType::BOOL:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+// 0 for types that aren't integers or floats
+unsigned Type::GetBitWidth(const ASTNodeType type) {
+  switch (type) {
+    case ASTNodeType::BOOL:
+      return 1;
+
+    case ASTNodeType::CHAR:
+    case ASTNodeType::INT8:
+    case ASTNodeType::UINT8:
+      return 8;
+
+    case ASTNodeType::INT16:
+    case ASTNodeType::UINT16:
+      return 16;
+
+    case ASTNodeType::INT:
+    case ASTNodeType::INT32:
+    case ASTNodeType::UINT:
+    case ASTNodeType::UINT32:
+    case ASTNodeType::FLOAT32:
+      return 32;
+
+    case ASTNodeType::INT64:
+    case ASTNodeType::UINT64:
+    case ASTNodeType::FLOAT:
+    case ASTNodeType::FLOAT64:
+      return 64;
+
+    default:
+      return 0;
+  }
+}
+
+// Type both operands are converted to before a binary operation: the wider one wins,
+// and with the same width unsigned wins like in C
+ASTNodeType Type::GetCommonType(const ASTNodeType type1, const ASTNodeType type2) {
+  const unsigned width1 = GetBitWidth(type1), width2 = GetBitWidth(type2);
+  if (width1 != width2)
+    return width1 > width2 ? type1 : type2;
+
+  return IsUnsigned(type2) && !IsUnsigned(type1) ? type2 : type1;
+}
+
+bool Type::IsVector(const ASTNodeType type) {
+  return GetLaneCount(type) != 0;
+}
+
+// Type of a single lane, types that aren't vectors are returned as they are
+ASTNodeType Type::GetElementType(const ASTNodeType type) {
+  switch (type) {
+    case ASTNodeType::INT32X4:
+    case ASTNodeType::INT32X8:
+      return ASTNodeType::INT32;
+
+    case ASTNodeType::INT64X2:
+    case ASTNodeType::INT64X4:
+      return ASTNodeType::INT64;
+
+    case ASTNodeType::FLOAT32X4:
+    case ASTNodeType::FLOAT32X8:
+      return ASTNodeType::FLOAT32;
+
+    case ASTNodeType::FLOAT64X2:
+    case ASTNodeType::FLOAT64X4:
+      return ASTNodeType::FLOAT64;
+
+    default:
+      return type;
+  }
+}
+
+// 0 for types that aren't vectors
+unsigned Type::GetLaneCount(const ASTNodeType type) {
+  switch (type) {
+    case ASTNodeType::INT64X2:
+    case ASTNodeType::FLOAT64X2:
+      return 2;
+
+    case ASTNodeType::INT32X4:
+    case ASTNodeType::INT64X4:
+    case ASTNodeType::FLOAT32X4:
+    case ASTNodeType::FLOAT64X4:
+      return 4;
+
+    case ASTNodeType::INT32X8:
+    case ASTNodeType::FLOAT32X8:
+      return 8;
+
+    default:
+      return 0;
+  }
+}
+
+// A scalar operand of a vector operation is broadcast to every lane
+bool Type::CanSplat(const ASTNodeType vector, const ASTNodeType scalar) {
+  return IsVector(vector) && !IsVector(scalar) && AreEquals(GetElementType(vector), scalar);
+}
+
+// Every numeric and vector type is followed by its pointer type in ASTNodeType
+bool Type::IsPointer(const ASTNodeType type) {
+  return type >= ASTNodeType::INT && type <= ASTNodeType::FLOAT64X4_PTR && (static_cast<int>(type) - static_cast<int>(ASTNodeType::INT)) % 2 == 1;
+}
+
+// Chars, bools and structs have no pointer type
+bool Type::CanPointTo(const ASTNodeType type) {
+  return type >= ASTNodeType::INT && type <= ASTNodeType::FLOAT64X4 && !IsPointer(type);
+}
+
+ASTNodeType Type::GetPointerType(const ASTNodeType type) {
+  return static_cast<ASTNodeType>(static_cast<int>(type) + 1);
+}
+
+ASTNodeType Type::GetPointeeType(const ASTNodeType type) {
+  return static_cast<ASTNodeType>(static_cast<int>(type) - 1);
+}
+
 ASTNodeType Type::TokenTypeToASTNodeType(const enum TokenType type) const {
   switch (type) {
     case TokenType::INT:
@@ -108,6 +259,30 @@ ASTNodeType Type::TokenTypeToASTNodeType(const enum TokenType type) const {
     case TokenType::FLOAT64:
       return ASTNodeType::FLOAT64;
 
+    case TokenType::INT32X4:
+      return ASTNodeType::INT32X4;
+
+    case TokenType::INT32X8:
+      return ASTNodeType::INT32X8;
+
+    case TokenType::INT64X2:
+      return ASTNodeType::INT64X2;
+
+    case TokenType::INT64X4:
+      return ASTNodeType::INT64X4;
+
+    case TokenType::FLOAT32X4:
+      return ASTNodeType::FLOAT32X4;
+
+    case TokenType::FLOAT32X8:
+      return ASTNodeType::FLOAT32X8;
+
+    case TokenType::FLOAT64X2:
+      return ASTNodeType::FLOAT64X2;
+
+    case TokenType::FLOAT64X4:
+      return ASTNodeType::FLOAT64X4;
+
     case TokenType::CHAR:
       return ASTNodeType::CHAR;
 
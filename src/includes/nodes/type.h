@@ -3,7 +3,7 @@
 
 class Type: public ASTNode {
 public:
-  Type(const Token& token, const bool isPointer);
+  Type(const Token& token, const bool isPointer, const uint64_t arraySize = 0);
 
   void accept(Codegen* generator) const override;
   void print(int indentation_level = 0) const override;
@@ -16,12 +16,27 @@ public:
   bool isNull() const;
   bool isPointer() const;
   bool isStruct() const; 
+  bool isArray() const;
+  bool isVector() const;
+  uint64_t getArraySize() const;
   string toString() const;
   static bool AreEquals(const ASTNodeType type1, const ASTNodeType type2);
+  static bool IsUnsigned(const ASTNodeType type);
+  static unsigned GetBitWidth(const ASTNodeType type);
+  static ASTNodeType GetCommonType(const ASTNodeType type1, const ASTNodeType type2);
+  static bool IsVector(const ASTNodeType type);
+  static ASTNodeType GetElementType(const ASTNodeType type);
+  static unsigned GetLaneCount(const ASTNodeType type);
+  static bool CanSplat(const ASTNodeType vector, const ASTNodeType scalar);
+  static bool IsPointer(const ASTNodeType type);
+  static bool CanPointTo(const ASTNodeType type);
+  static ASTNodeType GetPointerType(const ASTNodeType type);
+  static ASTNodeType GetPointeeType(const ASTNodeType type);
   ASTNodeType TokenTypeToASTNodeType(const enum TokenType type) const;
 
 private:
   const enum TokenType m_type;
   const string m_str;
   const bool m_isPointer;
+  const uint64_t m_arraySize; // 0 when the type isn't a fixed size array
 };
\ No newline at end of file
@@ -1,6 +1,9 @@
 #include "ASTNode.h"
 #include "expression.h"
 #include "unary_operator.h"
+#include "index_operator.h"
+#include "parameter.h"
+#include "variable.h"
 
 #include "../../backend/codegen.h"
 
@@ -26,18 +29,65 @@ const ASTNode* UnaryOperator::getRight() const {
   return m_right.get();
 }
 
+ASTNodeType UnaryOperator::getType() const {
+  return m_type;
+}
+
 ASTNodeType UnaryOperator::analyzeUnaryOperator(const UnaryOperator* unaryOperator) const {
-  const ASTNodeType type = Expression::analyzeExpression(unaryOperator->getRight());
+  const ASTNode* right = unaryOperator->getRight();
   const enum TokenType op = unaryOperator->getOperator();
 
-  if (op == TokenType::CARET){
-    if ((type >= ASTNodeType::INT && type <= ASTNodeType::FLOAT64_PTR) && !(static_cast<int>(type) % 2 == 0))
+  if (op == TokenType::AMPERSAND)
+    unaryOperator->m_type = Type::GetPointerType(analyzeAddress(right));
+  else {
+    const ASTNodeType type = Expression::analyzeExpression(right);
+    if (op == TokenType::CARET && !Type::IsPointer(type))
       error("Unary operator '^' can only be used to dereference pointers");
-    return static_cast<ASTNodeType>(static_cast<int>(type) - 1);
+
+    unaryOperator->m_type = op == TokenType::CARET ? Type::GetPointeeType(type) : type;
+    if (op == TokenType::NOT)
+      unaryOperator->setConstant(Constant::FoldNot(Constant::Of(right)));
+  }
+
+  return unaryOperator->m_type;
+}
+
+// Only variables, parameters and array elements have an address, constants are folded
+// into the code that reads them so they don't have one
+ASTNodeType UnaryOperator::analyzeAddress(const ASTNode* right) {
+  ASTNodeType type = ASTNodeType::NOTHING;
+  string name;
+
+  if (const Identifier* identifier = dynamic_cast<const Identifier*>(right)) {
+    name = identifier->toString();
+    if (!Scope::getCurrent()->isDeclared(name))
+      error("Identifier: " + name + " is not declared");
+
+    const Symbol& symbol = Scope::getCurrent()->find(name);
+    if (symbol.type == ASTNodeType::VARIABLE) {
+      const Variable* variable = std::get<const Variable*>(symbol.symbol);
+      if (variable->isConstant())
+        error("Unary operator '&' can't take the address of the constant " + name);
+      if (variable->isArray())
+        error("Unary operator '&' can only take the address of an element of the array " + name + ": &" + name + "[index]");
+      type = variable->getType();
+    }
+    else if (symbol.type == ASTNodeType::PARAMETER)
+      type = std::get<const Parameter*>(symbol.symbol)->getType();
   }
-  else if (op == TokenType::AMPERSAND){
-    return static_cast<ASTNodeType>(static_cast<int>(type) + 1);
+  else if (const IndexOperator* indexOperator = dynamic_cast<const IndexOperator*>(right)) {
+    name = indexOperator->getIdentifier()->toString();
+    type = Expression::analyzeExpression(indexOperator);
+
+    // Constant arrays are read-only, nothing can be written through the address of an element
+    const Symbol& symbol = Scope::getCurrent()->find(name);
+    if (symbol.type == ASTNodeType::VARIABLE && std::get<const Variable*>(symbol.symbol)->isConstant())
+      error("Unary operator '&' can't take the address of an element of the constant array " + name);
   }
   else
-    return type;
-}
\ No newline at end of file
+    error("Unary operator '&' can only take the address of a variable, a parameter or an array element");
+
+  if (!Type::CanPointTo(type))
+    error("Unary operator '&' can only take the address of integers, floats and vectors, " + name + " isn't one of them");
+  return type;
+}
@@ -14,8 +14,12 @@ public:
   const ASTNode* getRight() const;
   ASTNodeType getType() const;
   ASTNodeType analyzeUnaryOperator(const UnaryOperator* unaryOperator) const;
+  static ASTNodeType analyzeAddress(const ASTNode* right);
 
 private:
   unique_ptr<Operator> m_op;
   unique_ptr<ASTNode> m_right;
+
+  // Filled by the semantic analysis
+  mutable ASTNodeType m_type = ASTNodeType::NOTHING;
 };
\ No newline at end of file
@@ -27,6 +27,7 @@ void Variable::accept(Codegen* generator) const {
 
 void Variable::print(int indentation_level) const {
   cout << '\n' << std::setw(indentation_level) << " " << "Variable {\n";
+  printAnnotations(indentation_level + 2);
   cout << std::setw(indentation_level + 2) << " " << "keyword: " << m_keyword.lexemes << '\n';
   m_type->print(indentation_level + 2);
   m_identifier->print(indentation_level + 2);
@@ -50,10 +51,64 @@ ASTNode* Variable::getValue() const {
     return std::get<unique_ptr<ListInitializer>>(m_value).get();
 }
 
+// Only meaningful when the variable is initialized with an expression
+ASTNodeType Variable::getValueType() const {
+  return std::get<unique_ptr<Expression>>(m_value)->getType();
+}
+
+bool Variable::isConstant() const {
+  return m_keyword.type == TokenType::CONSTANT;
+}
+
+bool Variable::isGlobal() const {
+  return m_isGlobal;
+}
+
+// True when every value the variable starts with is known at compile time, an uninitialized
+// variable has none to compute. Struct variables start with the values given in the struct
+bool Variable::hasConstantInitializer() const {
+  const ASTNode* value = getValue();
+  if (const ListInitializer* list = dynamic_cast<const ListInitializer*>(value)) {
+    const vector<Expression*> elements = list->getList();
+    for (size_t index = 0; index < elements.size(); index++) {
+      const ASTNodeType type = m_structure && !isArray() ? m_structure->getMember(index)->getType() : getType();
+      if (!IsKnownValue(elements[index]->getASTNode(), type))
+        return false;
+    }
+    return true;
+  }
+
+  if (value->getNodeType() != ASTNodeType::NOTHING)
+    return IsKnownValue(value, getType());
+
+  if (m_structure && !isArray())
+    for (const Variable* member : m_structure->getMembers())
+      if (member->getValue()->getNodeType() != ASTNodeType::NOTHING && !IsKnownValue(member->getValue(), member->getType()))
+        return false;
+  return true;
+}
+
+// Scalars given to a vector are splat, so they're converted to the type of a lane
+bool Variable::IsKnownValue(const ASTNode* value, const ASTNodeType type) {
+  return Constant::Convert(Constant::Of(value), Type::GetElementType(type)).has_value();
+}
+
 bool Variable::isPointer() const {
   return m_type->isPointer();
 }
 
+bool Variable::isArray() const {
+  return m_type->isArray();
+}
+
+uint64_t Variable::getArraySize() const {
+  return m_type->getArraySize();
+}
+
+const Struct* Variable::getStructure() const {
+  return m_structure;
+}
+
 string Variable::getIdentifier() const {
   return m_identifier->toString();
 }
@@ -64,34 +119,84 @@ string Variable::getTypeToString() const {
 
 void Variable::analyzeVariable() const {
   const ASTNode* value = getValue();
-  if (m_type->isStruct()) {
-    if (Type::AreEquals(value->getNodeType(), ASTNodeType::NOTHING)) // It's just declared not initialized, no further checks needed
-      return;
+  if (m_type->isArray()) {
+    if (m_type->isStruct())
+      m_structure = std::get<const Struct*>(Scope::getCurrent()->find(getTypeToString()).symbol);
+
+    if (!Type::AreEquals(value->getNodeType(), ASTNodeType::NOTHING)) {
+      if (!Type::AreEquals(value->getNodeType(), ASTNodeType::LIST_INITIALIZER))
+        error("In variable declaration: " + getKeyword() + " " + getTypeToString() + " " + getIdentifier() + " is an array, so it can only be initialized with a list initializer", m_keyword.line);
+      if (m_type->isStruct())
+        error("In variable declaration: " + getKeyword() + " " + getTypeToString() + " " + getIdentifier() + " is an array of structs, its elements can't be initialized with a list initializer", m_keyword.line);
+      const vector<Expression*> list = std::get<unique_ptr<ListInitializer>>(m_value)->getList();
+
+      if (list.size() > m_type->getArraySize())
+        error("In variable declaration: " + getKeyword() + " " + getTypeToString() + " " + getIdentifier() + " the list initializer has more elements than the array", m_keyword.line);
+
+      for (size_t index = 0; index < list.size(); index++)
+        if (!Type::AreEquals(getType(), list[index]->getType()))
+          error("In variable declaration: " + getKeyword() + " " + getTypeToString() + " " + getIdentifier() + " the " + std::to_string(index + 1) + " element type doesn't match the array type", m_keyword.line);
+    }
+  }
+  else if (m_type->isStruct()) {
+    m_structure = std::get<const Struct*>(Scope::getCurrent()->find(getTypeToString()).symbol);
 
-    if (!Type::AreEquals(value->getNodeType(), ASTNodeType::LIST_INITIALIZER))
-      error("In variable declaration: " + getKeyword() + " " + getTypeToString() + " " + getIdentifier() + " is a struct type, so it can only be initialized with a list initializer");
-    const vector<Expression*> list = std::get<unique_ptr<ListInitializer>>(m_value)->getList();
-    const Struct* structure = std::get<const Struct*>(Scope::getInstance()->find(getTypeToString()).symbol);
+    // When it's just declared the members start with the values given in the struct, if any
+    if (!Type::AreEquals(value->getNodeType(), ASTNodeType::NOTHING)) {
+      if (!Type::AreEquals(value->getNodeType(), ASTNodeType::LIST_INITIALIZER))
+        error("In variable declaration: " + getKeyword() + " " + getTypeToString() + " " + getIdentifier() + " is a struct type, so it can only be initialized with a list initializer", m_keyword.line);
+      const vector<Expression*> list = std::get<unique_ptr<ListInitializer>>(m_value)->getList();
 
-    if (list.size() != structure->getMembersSize())
-      error("In this variable declaration: " + getKeyword() + " " + getTypeToString() + " " + getIdentifier() + " the numbers elements in the list initializer is different than the struct members required");
+      if (list.size() != m_structure->getMembersSize())
+        error("In this variable declaration: " + getKeyword() + " " + getTypeToString() + " " + getIdentifier() + " the numbers elements in the list initializer is different than the struct members required", m_keyword.line);
 
-    for (size_t index = 0; index < list.size(); index++) {
-      const ASTNodeType memberType = structure->getMember(index)->getType();
-      const ASTNodeType elementType = Expression::analyzeExpression(list[index]);
+      for (size_t index = 0; index < list.size(); index++) {
+        const ASTNodeType memberType = m_structure->getMember(index)->getType();
+        const ASTNodeType elementType = list[index]->getType();
 
-      if (memberType != elementType)
-        error("In variable declaration: " + getKeyword() + " " + getTypeToString() + " " + getIdentifier() + " the " + std::to_string(index + 1) + " element type doesn't match the one in the structure");
+        if (!Type::AreEquals(memberType, elementType) && !Type::CanSplat(memberType, elementType))
+          error("In variable declaration: " + getKeyword() + " " + getTypeToString() + " " + getIdentifier() + " the " + std::to_string(index + 1) + " element type doesn't match the one in the structure", m_keyword.line);
+      }
+    }
+  }
+  else if (m_type->isVector()) {
+    if (Type::AreEquals(value->getNodeType(), ASTNodeType::LIST_INITIALIZER)) {
+      const vector<Expression*> list = std::get<unique_ptr<ListInitializer>>(m_value)->getList();
+
+      if (list.size() != Type::GetLaneCount(getType()))
+        error("In variable declaration: " + getKeyword() + " " + getTypeToString() + " " + getIdentifier() + " the list initializer must have exactly " + std::to_string(Type::GetLaneCount(getType())) + " elements, one for every lane", m_keyword.line);
+
+      for (size_t index = 0; index < list.size(); index++)
+        if (!Type::AreEquals(Type::GetElementType(getType()), list[index]->getType()))
+          error("In variable declaration: " + getKeyword() + " " + getTypeToString() + " " + getIdentifier() + " the " + std::to_string(index + 1) + " element type doesn't match the vector lanes", m_keyword.line);
+    }
+    else if (!Type::AreEquals(value->getNodeType(), ASTNodeType::NOTHING)) {
+      const ASTNodeType valueType = getValueType();
+      if (valueType != getType() && !Type::CanSplat(getType(), valueType))
+        error("In variable declaration: " + getKeyword() + " " + getTypeToString() + " " + getIdentifier() + " can only be initialized with the same vector type or with a scalar of its element type", m_keyword.line);
     }
   }
   else {    
     const ASTNodeType valueType = Expression::analyzeExpression(value);
     if (Type::AreEquals(valueType, ASTNodeType::NOTHING) && Type::AreEquals(valueType, getType()))
       error("In variable declaration: " + getKeyword() + " " + getTypeToString() + " " + getIdentifier() + " the value and the type doesn't match " + 
-        std::to_string(static_cast<int>((Expression::analyzeExpression(value)))) + " !=" + std::to_string(static_cast<int>(getType())));
+        std::to_string(static_cast<int>((Expression::analyzeExpression(value)))) + " !=" + std::to_string(static_cast<int>(getType())), m_keyword.line);
+    if (Type::IsVector(valueType))
+      error("In variable declaration: " + getKeyword() + " " + getTypeToString() + " " + getIdentifier() + " can't be initialized with a vector, use extract or the reduce_* builtins", m_keyword.line);
+    if ((Type::IsPointer(valueType) || Type::IsPointer(getType())) && valueType != getType() && valueType != ASTNodeType::NOTHING)
+      error("In variable declaration: " + getKeyword() + " " + getTypeToString() + " " + getIdentifier() + " a pointer can only be initialized with a pointer of the same type", m_keyword.line);
+
+    // Every use of a constant initialized with a value known at compile time is replaced by it
+    if (isConstant() && !m_isMember)
+      setConstant(Constant::Convert(Constant::Of(value), getType()));
   }
 
+  // The initial value of a global is part of the program data, no code runs before main to compute it
+  m_isGlobal = !m_isMember && Scope::getCurrent()->isGlobalScope();
+  if (m_isGlobal && !hasConstantInitializer())
+    error("In variable declaration: " + getKeyword() + " " + getTypeToString() + " " + getIdentifier() + " is a global variable, it can only be initialized with values known at compile time", m_keyword.line);
+
   if (!m_isMember){
-    Scope::getInstance()->declare(m_identifier->toString(), Symbol(this));
+    Scope::getCurrent()->declare(m_identifier->toString(), Symbol(this));
   }
 }
\ No newline at end of file
@@ -1,14 +1,16 @@
 #pragma once
 
 #include "ASTNode.h"
+#include "annotation.h"
 #include "expression.h"
 #include "identifier.h"
 #include "list_initializer.h"
 #include "type.h"
 
 class Identifier;
+class Struct;
 
-class Variable: public ASTNode {
+class Variable: public ASTNode, public Annotated {
 public:
   using ValueVariant = variant<string, unique_ptr<Expression>, unique_ptr<ListInitializer>>;
 
@@ -21,10 +23,17 @@ public:
   string getKeyword() const;
   ASTNodeType getType() const;
   ASTNode* getValue() const;
+  ASTNodeType getValueType() const;
   string getIdentifier() const;
   string getTypeToString() const;
 
+  bool isConstant() const;
+  bool isGlobal() const;
+  bool hasConstantInitializer() const;
   bool isPointer() const;
+  bool isArray() const;
+  uint64_t getArraySize() const;
+  const Struct* getStructure() const;
   void analyzeVariable() const;
   
 private:
@@ -33,4 +42,8 @@ private:
   unique_ptr<Identifier> m_identifier;
   ValueVariant m_value;
   const bool m_isMember;
+  mutable const Struct* m_structure = nullptr; // Only for struct variables and arrays of structs
+  mutable bool m_isGlobal = false; // Filled by the semantic analysis, declared at the top level
+
+  static bool IsKnownValue(const ASTNode* value, const ASTNodeType type);
 };
\ No newline at end of file
@@ -11,6 +11,7 @@ void While::accept(Codegen* generator) const {
 
 void While::print(int indetation_level) const {
   cout << '\n' << setw(indetation_level) << " " << "While Statement{\n";
+  printAnnotations(indetation_level + 2);
   m_condition->print(indetation_level + 2);
   m_body->print(indetation_level + 2);
   cout << setw(indetation_level) << " " << "}\n";
@@ -1,10 +1,11 @@
 #pragma once
 
 #include "ASTNode.h"
+#include "annotation.h"
 #include "expression.h"
 #include "body.h"
 
-class While: public ASTNode {
+class While: public ASTNode, public Annotated {
 public:
   While(unique_ptr<Expression> condition, unique_ptr<Body> body);
   
@@ -0,0 +1,273 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <vector>
+
+using std::cerr;
+using std::string, std::string_view, std::vector;
+
+class Options {
+public:
+  // How modules compiled to bitcode are optimized together, see LinkTimeOptimizer
+  enum class LTO { FULL, THIN };
+
+  Options(int argc, char* argv[]) {
+    parse(argc, argv);
+  }
+
+  // Empty when bitcode files are linked instead
+  const vector<string>& getSourcePaths() const {
+    return m_sourcePaths;
+  }
+
+  // Sources compiled at the same time, each on its own thread
+  unsigned getJobs() const {
+    return m_jobs;
+  }
+
+  // Modules compiled with -o <file.bc>, linked and optimized together
+  const vector<string>& getBitcodePaths() const {
+    return m_bitcodePaths;
+  }
+
+  LTO getLTOMode() const {
+    return m_ltoMode;
+  }
+
+  // The module is written as bitcode for a later link step instead of an object file
+  bool isWritingBitcode() const {
+    return IsBitcode(m_outputPath);
+  }
+
+  // The modules are optimized again once they're linked together: they're written as bitcode,
+  // or several sources are compiled with --lto
+  bool isLinkTimeOptimized() const {
+    return isWritingBitcode() || (m_isLTOEnabled && m_sourcePaths.size() > 1);
+  }
+
+  bool isCacheEnabled() const {
+    return m_isCacheEnabled;
+  }
+
+  const string& getCacheDir() const {
+    return m_cacheDir;
+  }
+
+  uintmax_t getCacheSize() const {
+    return m_cacheSize;
+  }
+
+  unsigned getOptimizationLevel() const {
+    return m_optimizationLevel;
+  }
+
+  unsigned getIRThreads() const {
+    return m_irThreads;
+  }
+
+  // Empty when the program is run with the JIT
+  const string& getOutputPath() const {
+    return m_outputPath;
+  }
+
+  // -j when --codegen-threads isn't given
+  unsigned getCodegenThreads() const {
+    return m_codegenThreads != 0 ? m_codegenThreads : m_jobs;
+  }
+
+  bool areBoundsChecksEnabled() const {
+    return m_areBoundsChecksEnabled;
+  }
+
+  // Where the instrumented program writes its profile, empty when it isn't instrumented
+  const string& getProfileGeneratePath() const {
+    return m_profileGeneratePath;
+  }
+
+  // Indexed profile the optimizer is guided by, empty when there's none
+  const string& getProfileUsePath() const {
+    return m_profileUsePath;
+  }
+
+  // Every option that changes the generated code must be part of this string,
+  // it's hashed together with the source to build the compilation cache key
+  string getFingerprint() const {
+    string fingerprint = "O" + std::to_string(m_optimizationLevel) + ";ir-threads=" + std::to_string(m_irThreads) +
+                         ";bounds-checks=" + std::to_string(m_areBoundsChecksEnabled) + ";profile-generate=" + m_profileGeneratePath +
+                         ";bitcode=" + std::to_string(isLinkTimeOptimized()) + ";lto=" + std::to_string(static_cast<int>(m_ltoMode));
+
+    // A new profile for the same source has to be optimized again
+    if (!m_profileUsePath.empty()) {
+      std::error_code ec;
+      const auto modified = std::filesystem::last_write_time(m_profileUsePath, ec);
+      fingerprint += ";profile-use=" + m_profileUsePath + "@" + std::to_string(ec ? 0 : modified.time_since_epoch().count());
+    }
+    return fingerprint;
+  }
+
+private:
+  vector<string> m_sourcePaths;
+  vector<string> m_bitcodePaths;
+  bool m_isLTOEnabled = false;
+  LTO m_ltoMode = LTO::FULL;
+  unsigned m_jobs = 1;
+  bool m_isCacheEnabled = false;
+  string m_cacheDir = ".shqcache";
+  uintmax_t m_cacheSize = 256ull * 1024 * 1024;
+  unsigned m_optimizationLevel = 0;
+  unsigned m_irThreads = 1;
+  string m_outputPath;
+  unsigned m_codegenThreads = 0;
+  bool m_areBoundsChecksEnabled = true;
+  string m_profileGeneratePath;
+  string m_profileUsePath;
+
+  void parse(int argc, char* argv[]) {
+    bool isProfileGenerated = false;
+    for (int i = 1; i < argc; i++) {
+      const string_view argument = argv[i];
+
+      if (argument == "--cache")
+        m_isCacheEnabled = true;
+
+      else if (argument.rfind("--cache-dir=", 0) == 0) {
+        m_isCacheEnabled = true;
+        m_cacheDir = argument.substr(string_view("--cache-dir=").size());
+      }
+
+      else if (argument.rfind("--cache-size=", 0) == 0)
+        m_cacheSize = parseNumber(argument, argument.substr(string_view("--cache-size=").size())) * 1024 * 1024;
+
+      else if (argument == "-O0" || argument == "-O1" || argument == "-O2" || argument == "-O3")
+        m_optimizationLevel = argument[2] - '0';
+
+      else if (argument.rfind("--ir-threads=", 0) == 0)
+        m_irThreads = parseThreads(argument, argument.substr(string_view("--ir-threads=").size()));
+
+      else if (argument == "-o") {
+        if (++i >= argc)
+          usage("Option -o expects the path of the object file");
+        m_outputPath = argv[i];
+      }
+
+      else if (argument == "-j") {
+        if (++i >= argc)
+          usage("Option -j expects the number of threads");
+        m_jobs = parseThreads(argument, argv[i]);
+      }
+
+      else if (argument.rfind("--codegen-threads=", 0) == 0)
+        m_codegenThreads = parseThreads(argument, argument.substr(string_view("--codegen-threads=").size()));
+
+      else if (argument == "--no-bounds-checks")
+        m_areBoundsChecksEnabled = false;
+
+      else if (argument == "--profile-generate")
+        isProfileGenerated = true;
+
+      else if (argument.rfind("--profile-generate=", 0) == 0) {
+        isProfileGenerated = true;
+        m_profileGeneratePath = argument.substr(string_view("--profile-generate=").size());
+      }
+
+      else if (argument.rfind("--profile-use=", 0) == 0) {
+        m_profileUsePath = argument.substr(string_view("--profile-use=").size());
+        if (m_profileUsePath.empty())
+          usage("Option --profile-use expects the path of the profile");
+      }
+
+      else if (argument == "--lto" || argument == "--lto=full") {
+        m_isLTOEnabled = true;
+        m_ltoMode = LTO::FULL;
+      }
+
+      else if (argument == "--lto=thin") {
+        m_isLTOEnabled = true;
+        m_ltoMode = LTO::THIN;
+      }
+
+      else if (argument.rfind("-", 0) == 0)
+        usage("Unknown option: " + string(argument));
+
+      else if (IsBitcode(argument))
+        m_bitcodePaths.emplace_back(argument);
+
+      else
+        m_sourcePaths.emplace_back(argument);
+    }
+
+    if (m_sourcePaths.empty() && m_bitcodePaths.empty())
+      usage("You must insert the source code path");
+    if (!m_sourcePaths.empty() && !m_bitcodePaths.empty())
+      usage("Source files can't be linked with bitcode files, compile them with -o <file.bc> first");
+    if (!m_bitcodePaths.empty() && isWritingBitcode())
+      usage("Bitcode files are linked into an object file or run, not into another bitcode file");
+
+    // The instrumentation and the counts are added while the modules are compiled, not when they're linked
+    const bool isLinkTime = isLinkTimeOptimized() || !m_bitcodePaths.empty();
+    if ((isProfileGenerated || !m_profileUsePath.empty()) && isLinkTime)
+      usage("Profiles can't be used with link time optimization");
+
+    // The JIT writes the indexed profile itself, linked programs write a raw one with compiler-rt
+    if (isProfileGenerated && m_profileGeneratePath.empty())
+      m_profileGeneratePath = m_outputPath.empty() ? "default.profdata" : "default.profraw";
+    if (isProfileGenerated && !m_profileUsePath.empty())
+      usage("Options --profile-generate and --profile-use can't be used together");
+    if ((isProfileGenerated || !m_profileUsePath.empty()) && m_irThreads > 1)
+      usage("Profiles need the whole module optimized at once, they can't be used with --ir-threads");
+  }
+
+  static bool IsBitcode(const string_view path) {
+    const string_view extension = ".bc";
+    return path.size() > extension.size() && path.substr(path.size() - extension.size()) == extension;
+  }
+
+  uintmax_t parseNumber(const string_view argument, const string_view value) const {
+    if (value.empty() || value.find_first_not_of("0123456789") != string_view::npos)
+      usage("Option " + string(argument) + " expects a positive number");
+    return std::stoull(string(value));
+  }
+
+  unsigned parseThreads(const string_view argument, const string_view value) const {
+    const uintmax_t threads = parseNumber(argument, value);
+    if (threads == 0)
+      usage("Option " + string(argument) + " expects at least one thread");
+    return static_cast<unsigned>(threads);
+  }
+
+  [[noreturn]] void usage(const string& message) const {
+    cerr << message << "\n";
+    cerr << "Correct usage is: comp [options] <file.shq>...\n";
+    cerr << "                  comp [options] <file.bc>...\n";
+    cerr << "Options:\n";
+    cerr << "  -O<0-3>               optimization level (default: -O0)\n";
+    cerr << "  --ir-threads=<N>      generate and optimize functions on N threads, each with its own\n";
+    cerr << "                        LLVM context, then link the results (no cross-function inlining).\n";
+    cerr << "                        With --lto=thin, the number of modules optimized at the same time\n";
+    cerr << "  -o <file>             write a native object file instead of running the program, or the module\n";
+    cerr << "                        as bitcode if the file ends with .bc, to be linked with others later\n";
+    cerr << "  -j <N>                compile N source files at the same time, each on its own thread,\n";
+    cerr << "                        and emit the object file on N threads unless --codegen-threads is given\n";
+    cerr << "  --codegen-threads=<N>\n";
+    cerr << "                        split the module and emit the object file on N threads\n";
+    cerr << "  --lto[=full|thin]     optimize bitcode files, or several sources, again once they're linked:\n";
+    cerr << "                        as a single module (default), or each on its own importing the small\n";
+    cerr << "                        functions it calls from the others. Given when compiling to bitcode,\n";
+    cerr << "                        it picks the pipeline\n";
+    cerr << "  --no-bounds-checks    don't check array indices at runtime\n";
+    cerr << "  --profile-generate[=<file>]\n";
+    cerr << "                        instrument the program to count how often every branch is taken.\n";
+    cerr << "                        Run with the JIT it writes an indexed profile (default: default.profdata),\n";
+    cerr << "                        built with -o a raw one to merge with llvm-profdata (default: default.profraw)\n";
+    cerr << "  --profile-use=<file>  optimize with the branch and call counts of an indexed profile\n";
+    cerr << "  --cache               reuse the result of previous compilations of the same source\n";
+    cerr << "  --cache-dir=<dir>     directory used by the compilation cache (default: .shqcache)\n";
+    cerr << "  --cache-size=<MB>     maximum size of the cache directory (default: 256)\n";
+    exit(EXIT_FAILURE);
+  }
+};
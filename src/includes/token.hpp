@@ -1,6 +1,9 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 using std::string;
 
 
@@ -15,6 +18,7 @@ enum class TokenType {
   IDENTIFIER,
   AMPERSAND,
   CARET,
+  ANNOTATION,
 
   //TYPES 
   ARRAY_INT,
@@ -44,6 +48,15 @@ enum class TokenType {
   BOOL,
   NOTHING, //Can't write NULL because of some windows libraries
 
+  INT32X4,
+  INT32X8,
+  INT64X2,
+  INT64X4,
+  FLOAT32X4,
+  FLOAT32X8,
+  FLOAT64X2,
+  FLOAT64X4,
+
   //LITERALS
   LITERAL_INTEGER,
   LITERAL_FLOAT,
@@ -59,11 +72,18 @@ enum class TokenType {
   DO,
   WHILE,
   FOR,
+  PARALLEL,
   BREAK,
   CONTINUE,
   FUNC,
   RETURN,
+  TAIL,
   STRUCT,
+  RESTRICT,
+  SWITCH,
+  CASE,
+  DEFAULT,
+  IMPORT,
 
   //LOGICAL
   AND,
@@ -107,15 +127,91 @@ enum class TokenType {
   FLOAT_BEGIN = FLOAT,
   FLOAT_END = FLOAT64,
 
+  VECTORS_BEGIN = INT32X4,
+  VECTORS_END = FLOAT64X4,
+
   LITERALS_BEGIN = LITERAL_INTEGER,
   LITERALS_END = LITERAL_BOOLEAN,
 
   OPERATOR_COMPARISON_BEGIN = EQUALS,
   OPERATOR_COMPARISON_END = LESS_EQUAL,
 
+  OPERATOR_MATH_BEGIN = ADDITION,
+  OPERATOR_MATH_END = MODULUS,
+
 };
 
 
+// Words the tokenizer reads as keywords, the other words are identifiers
+inline const std::unordered_map<std::string_view, TokenType> keywordMap = {
+  { "var", TokenType::VAR },
+  { "const", TokenType::CONSTANT },
+  { "int8", TokenType::INT8 },
+  { "int16", TokenType::INT16 },
+  { "int32", TokenType::INT32 },
+  { "int64", TokenType::INT64 },
+  { "int", TokenType::INT },
+  { "uint8", TokenType::UINT8 },
+  { "uint16", TokenType::UINT16 },
+  { "uint32", TokenType::UINT32 },
+  { "uint64", TokenType::UINT64 },
+  { "uint", TokenType::UINT},
+  { "float32", TokenType::FLOAT32 },
+  { "float64", TokenType::FLOAT64 },
+  { "float", TokenType::FLOAT },
+  { "int32x4", TokenType::INT32X4 },
+  { "int32x8", TokenType::INT32X8 },
+  { "int64x2", TokenType::INT64X2 },
+  { "int64x4", TokenType::INT64X4 },
+  { "float32x4", TokenType::FLOAT32X4 },
+  { "float32x8", TokenType::FLOAT32X8 },
+  { "float64x2", TokenType::FLOAT64X2 },
+  { "float64x4", TokenType::FLOAT64X4 },
+  { "char", TokenType::CHAR },
+  { "string", TokenType::STRING },
+  { "bool", TokenType::BOOL },
+  { "null", TokenType::NOTHING },
+  { "if", TokenType::IF },
+  { "else", TokenType::ELSE },
+  { "do", TokenType::DO },
+  { "while", TokenType::WHILE },
+  { "for", TokenType::FOR },
+  { "parallel", TokenType::PARALLEL },
+  { "break", TokenType::BREAK },
+  { "continue", TokenType::CONTINUE },
+  { "fn", TokenType::FUNC },
+  { "return", TokenType::RETURN },
+  { "tail", TokenType::TAIL },
+  { "struct", TokenType::STRUCT },
+  { "restrict", TokenType::RESTRICT },
+  { "switch", TokenType::SWITCH },
+  { "case", TokenType::CASE },
+  { "default", TokenType::DEFAULT },
+  { "import", TokenType::IMPORT },
+  { "true", TokenType::LITERAL_BOOLEAN },
+  { "false", TokenType::LITERAL_BOOLEAN },
+  { "and", TokenType::AND},
+  { "or", TokenType::OR},
+};
+
+// Words that turn a '#' into an annotation, any other '#' starts a comment
+inline const std::unordered_set<string> annotationSet = {
+  "vectorize",
+  "unroll",
+  "chunk",
+  "packed",
+  "align",
+  "reorder",
+  "soa",
+  "inline",
+  "noinline",
+  "hot",
+  "cold",
+  "export",
+  "likely",
+  "unlikely",
+};
+
 struct Token {
   TokenType type;
   string lexemes;
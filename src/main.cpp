@@ -1,25 +1,181 @@
 #include <iostream>
+#include <atomic>
 #include <chrono>
+#include <optional>
+#include <thread>
 
-#include "./frontend/preprocessing.hpp"  
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Linker/Linker.h"
+
+#include "./includes/options.hpp"
+#include "./frontend/preprocessing.hpp"
 #include "./frontend/tokenizer.hpp"
 #include "./frontend/parser.hpp"
 //#include "./includes/ast.hpp"
 #include "./backend/codegen.h"
+#include "./backend/cache.h"
+#include "./backend/emitter.h"
+#include "./backend/lto.h"
 
-int main(int argc, char* argv[]){
-  auto start = std::chrono::high_resolution_clock::now();
+using Clock = std::chrono::high_resolution_clock;
 
-  Preprocessor preprocessed(argc, argv);
-  Tokenizer tokenizer(preprocessed.getSrc());
-  Parser parser(tokenizer.getTokens());
-  Codegen codegen(parser.getAST());
-
-  auto end = std::chrono::high_resolution_clock::now();
+void printCompileTime(const Clock::time_point start) {
+  auto end = Clock::now();
 
   auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
   double seconds = std::chrono::duration<double>(duration).count();
   cout << "Compiling took: " << seconds << " seconds\n";
+}
+
+// Runs the program with the JIT, or writes it as an object file or as bitcode
+void output(unique_ptr<llvm::Module> module, const Options& options) {
+  if (options.getOutputPath().empty())
+    Codegen::executeModule(std::move(module), options);
+  else if (options.isWritingBitcode())
+    LinkTimeOptimizer::writeBitcode(*module, options);
+  else
+    ObjectEmitter(options).emit(*module);
+}
+
+// A module is compiled with the declarations of the ones it imports, a cached module is only
+// valid while their interfaces stay the same
+string getImportsFingerprint(const vector<Token>& tokens, const string& path) {
+  size_t index = 0;
+  string fingerprint;
+  for (const shared_ptr<const ModuleInterface>& module : ModuleInterface::ImportAll(tokens, index, path))
+    fingerprint += " " + module->getPath() + ":" + std::to_string(module->getKey());
+  return fingerprint;
+}
+
+// Preprocessing, lexing, parsing with the semantic analysis and IR generation of one of the
+// sources. Every file has its own scope and LLVM context, the optimized module is handed over as bitcode
+unique_ptr<llvm::MemoryBuffer> compileFile(const string& path, const Options& options) {
+  diagnosticSourcePath = path;
+  Preprocessor preprocessed(path);
+
+  llvm::SmallVector<char, 0> bitcode;
+  llvm::raw_svector_ostream stream(bitcode);
+
+  Tokenizer tokenizer(preprocessed.getSrc());
+
+  std::optional<CompilationCache> cache;
+  string key;
+  if (options.isCacheEnabled()) {
+    cache.emplace(options.getCacheDir(), options.getCacheSize());
+    key = cache->getKey(preprocessed.getSrc(), options.getFingerprint() + getImportsFingerprint(tokenizer.getTokens(), path));
+
+    llvm::LLVMContext context;
+    if (unique_ptr<llvm::Module> module = cache->load(key, context)) {
+      cout << "Loaded " + path + " from cache: " + key + "\n";
+      LinkTimeOptimizer::writeBitcode(*module, stream, options);
+      return llvm::MemoryBuffer::getMemBufferCopy(llvm::StringRef(bitcode.data(), bitcode.size()), path);
+    }
+  }
+
+  Parser parser(tokenizer.getTokens(), path);
+  Codegen codegen(parser.getAST(), options);
+  codegen.optimize();
+
+  if (cache)
+    cache->store(key, codegen.getModule());
+
+  LinkTimeOptimizer::writeBitcode(*codegen.getModule(), stream, options);
+  return llvm::MemoryBuffer::getMemBufferCopy(llvm::StringRef(bitcode.data(), bitcode.size()), path);
+}
+
+// Up to -j files are compiled at the same time, every thread takes the next one left. The
+// modules are linked once they're all done, and optimized again with --lto
+unique_ptr<llvm::Module> compileFiles(const Options& options, llvm::LLVMContext& context) {
+  const vector<string>& paths = options.getSourcePaths();
+  vector<unique_ptr<llvm::MemoryBuffer>> buffers(paths.size());
+
+  std::atomic<size_t> next = 0;
+  vector<std::thread> workers;
+  for (size_t worker = 0; worker < std::min<size_t>(options.getJobs(), paths.size()); worker++) {
+    workers.emplace_back([&]() {
+      for (size_t index = next++; index < paths.size(); index = next++)
+        buffers[index] = compileFile(paths[index], options);
+    });
+  }
+  for (std::thread& worker : workers)
+    worker.join();
+
+  if (options.isLinkTimeOptimized() && !options.isWritingBitcode())
+    return LinkTimeOptimizer(options, std::move(buffers)).link(context);
+
+  unique_ptr<llvm::Module> module;
+  unique_ptr<llvm::Linker> linker;
+  for (const unique_ptr<llvm::MemoryBuffer>& buffer : buffers) {
+    llvm::Expected<unique_ptr<llvm::Module>> compiled = llvm::parseBitcodeFile(buffer->getMemBufferRef(), context);
+    if (!compiled)
+      error("Couldn't read back the module of " + buffer->getBufferIdentifier().str() + ": " + llvm::toString(compiled.takeError()));
+
+    if (!module) {
+      module = std::move(*compiled);
+      linker = std::make_unique<llvm::Linker>(*module);
+    }
+    else if (linker->linkInModule(std::move(*compiled)))
+      error("Couldn't link " + buffer->getBufferIdentifier().str());
+  }
+  return module;
+}
+
+int main(int argc, char* argv[]){
+  auto start = Clock::now();
+
+  Options options(argc, argv);
+
+  // Modules already compiled to bitcode are only linked and optimized together
+  if (!options.getBitcodePaths().empty()) {
+    llvm::LLVMContext context;
+    unique_ptr<llvm::Module> module = LinkTimeOptimizer(options).link(context);
+    printCompileTime(start);
+    output(std::move(module), options);
+    return 0;
+  }
+
+  if (options.getSourcePaths().size() > 1) {
+    llvm::LLVMContext context;
+    unique_ptr<llvm::Module> module = compileFiles(options, context);
+    printCompileTime(start);
+    output(std::move(module), options);
+    return 0;
+  }
+
+  const string& path = options.getSourcePaths().front();
+  Preprocessor preprocessed(path);
+  Tokenizer tokenizer(preprocessed.getSrc());
+
+  std::optional<CompilationCache> cache;
+  string key;
+  if (options.isCacheEnabled()) {
+    cache.emplace(options.getCacheDir(), options.getCacheSize());
+    key = cache->getKey(preprocessed.getSrc(), options.getFingerprint() + getImportsFingerprint(tokenizer.getTokens(), path));
+
+    llvm::LLVMContext context;
+    if (unique_ptr<llvm::Module> module = cache->load(key, context)) {
+      cout << "Loaded from cache: " << key << "\n";
+      printCompileTime(start);
+      output(std::move(module), options);
+      return 0;
+    }
+  }
+
+  Parser parser(tokenizer.getTokens(), path);
+  Codegen codegen(parser.getAST(), options);
+  codegen.optimize();
+
+  if (cache)
+    cache->store(key, codegen.getModule());
+
+  printCompileTime(start);
+
+  if (options.getOutputPath().empty())
+    codegen.executeIR();
+  else if (options.isWritingBitcode())
+    LinkTimeOptimizer::writeBitcode(*codegen.getModule(), options);
+  else
+    ObjectEmitter(options).emit(*codegen.getModule());
 
   return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,174 @@
+#include "parallel.h"
+
+// The runtime is linked into the objects emitted with -o, so it only depends on libc and
+// pthreads: a program linked with a plain C compiler mustn't need the C++ standard library
+
+// C Headers
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// C++ Headers
+#include <atomic>
+
+namespace {
+
+constexpr unsigned MAX_WORKERS = 256;
+
+// Iterations still to be run by a worker, the owner takes from the front and thieves from the back
+struct alignas(64) Range {
+  std::atomic_flag lock = ATOMIC_FLAG_INIT;
+  int64_t begin = 0;
+  int64_t end = 0;
+
+  void acquire() {
+    while (lock.test_and_set(std::memory_order_acquire))
+      sched_yield();
+  }
+
+  void release() {
+    lock.clear(std::memory_order_release);
+  }
+};
+
+struct Pool {
+  pthread_once_t initialized = PTHREAD_ONCE_INIT;
+  pthread_mutex_t call = PTHREAD_MUTEX_INITIALIZER;   // one parallel for at a time
+  pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;  // protects generation and active
+  pthread_cond_t wake = PTHREAD_COND_INITIALIZER;
+  pthread_cond_t done = PTHREAD_COND_INITIALIZER;
+  uint64_t generation = 0;
+  unsigned active = 0;
+  unsigned workers = 1; // the calling thread is worker 0
+
+  ParallelBody body = nullptr;
+  void* context = nullptr;
+  int64_t chunk = 1;
+  Range ranges[MAX_WORKERS];
+};
+
+Pool pool;
+
+// A parallel for nested in the body of another one runs on the thread that reached it
+thread_local bool isInsideParallel = false;
+
+bool takeChunk(const unsigned self, int64_t& begin, int64_t& end) {
+  Range& range = pool.ranges[self];
+  range.acquire();
+  begin = range.begin;
+  end = range.end - range.begin > pool.chunk ? range.begin + pool.chunk : range.end;
+  range.begin = end;
+  range.release();
+  return begin < end;
+}
+
+bool steal(const unsigned self) {
+  for (unsigned offset = 1; offset < pool.workers; offset++) {
+    Range& victim = pool.ranges[(self + offset) % pool.workers];
+    victim.acquire();
+    const int64_t remaining = victim.end - victim.begin;
+    if (remaining <= 0) {
+      victim.release();
+      continue;
+    }
+
+    const int64_t middle = victim.begin + remaining / 2;
+    const int64_t end = victim.end;
+    victim.end = middle;
+    victim.release();
+
+    Range& range = pool.ranges[self];
+    range.acquire();
+    range.begin = middle;
+    range.end = end;
+    range.release();
+    return true;
+  }
+  return false;
+}
+
+void run(const unsigned self) {
+  int64_t begin, end;
+  do {
+    while (takeChunk(self, begin, end))
+      pool.body(pool.context, begin, end);
+  } while (steal(self));
+}
+
+void* work(void* argument) {
+  const unsigned self = static_cast<unsigned>(reinterpret_cast<uintptr_t>(argument));
+  isInsideParallel = true;
+
+  uint64_t seen = 0;
+  for (;;) {
+    pthread_mutex_lock(&pool.mutex);
+    while (pool.generation == seen)
+      pthread_cond_wait(&pool.wake, &pool.mutex);
+    seen = pool.generation;
+    pthread_mutex_unlock(&pool.mutex);
+
+    run(self);
+
+    pthread_mutex_lock(&pool.mutex);
+    if (--pool.active == 0)
+      pthread_cond_signal(&pool.done);
+    pthread_mutex_unlock(&pool.mutex);
+  }
+  return nullptr;
+}
+
+void initialize() {
+  long workers = sysconf(_SC_NPROCESSORS_ONLN);
+  if (const char* threads = getenv("SHQ_THREADS"))
+    workers = atol(threads);
+  workers = workers < 1 ? 1 : workers > static_cast<long>(MAX_WORKERS) ? MAX_WORKERS : workers;
+
+  pool.workers = 1;
+  for (long index = 1; index < workers; index++) {
+    pthread_t thread;
+    if (pthread_create(&thread, nullptr, work, reinterpret_cast<void*>(static_cast<uintptr_t>(index))) != 0)
+      break;
+    pthread_detach(thread);
+    pool.workers++;
+  }
+}
+
+}
+
+extern "C" __attribute__((weak)) void shq_parallel_for(ParallelBody body, void* context, int64_t iterations, int64_t chunk) {
+  if (iterations <= 0)
+    return;
+
+  pthread_once(&pool.initialized, initialize);
+  if (isInsideParallel || pool.workers == 1) {
+    body(context, 0, iterations);
+    return;
+  }
+
+  pthread_mutex_lock(&pool.call);
+  pool.body = body;
+  pool.context = context;
+  pool.chunk = chunk > 0 ? chunk : iterations / (pool.workers * 16) + 1;
+  const int64_t share = iterations / pool.workers, extra = iterations % pool.workers;
+  for (unsigned index = 0; index < pool.workers; index++) {
+    pool.ranges[index].begin = share * index + (index < extra ? index : extra);
+    pool.ranges[index].end = pool.ranges[index].begin + share + (index < extra ? 1 : 0);
+  }
+
+  pthread_mutex_lock(&pool.mutex);
+  pool.active = pool.workers - 1;
+  pool.generation++;
+  pthread_cond_broadcast(&pool.wake);
+  pthread_mutex_unlock(&pool.mutex);
+
+  isInsideParallel = true;
+  run(0);
+  isInsideParallel = false;
+
+  pthread_mutex_lock(&pool.mutex);
+  while (pool.active > 0)
+    pthread_cond_wait(&pool.done, &pool.mutex);
+  pthread_mutex_unlock(&pool.mutex);
+  pthread_mutex_unlock(&pool.call);
+}
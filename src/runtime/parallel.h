@@ -0,0 +1,17 @@
+#pragma once
+
+// C Headers
+#include <stdint.h>
+
+// Name of the entry point, shared with the codegen that emits the calls
+#define SHQ_PARALLEL_FOR "shq_parallel_for"
+
+// Body of an outlined `parallel for`, it runs the iterations [begin, end)
+typedef void (*ParallelBody)(void* context, int64_t begin, int64_t end);
+
+// Runs body over the iterations [0, iterations) on a pool of worker threads and returns
+// once all of them are done. Every worker starts with an equal share of the range and
+// takes chunk iterations at a time from its front, idle workers steal the back half of
+// the range of a busy one. A chunk of 0 picks one from the number of workers.
+// SHQ_THREADS sets the number of workers, by default there's one per online CPU.
+extern "C" void shq_parallel_for(ParallelBody body, void* context, int64_t iterations, int64_t chunk);